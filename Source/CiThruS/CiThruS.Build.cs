@@ -27,6 +27,8 @@ public class CiThruS : ModuleRules
 		var kvazaar_base_path = Path.Combine(thirdparty_directory, "Kvazaar/");
 		var openhevc_base_path = Path.Combine(thirdparty_directory, "OpenHEVC/");
 		var fpng_base_path = Path.Combine(thirdparty_directory, "fpng/");
+		var lz4_base_path = Path.Combine(thirdparty_directory, "LZ4/");
+		var zstd_base_path = Path.Combine(thirdparty_directory, "Zstd/");
 		var pahocpp_base_path = Path.Combine(thirdparty_directory, "PahoCpp/");
 		
         if (Target.Platform == UnrealTargetPlatform.Win64)
@@ -35,6 +37,8 @@ public class CiThruS : ModuleRules
 			AddStaticLibraryIfExists(Path.Combine(kvazaar_base_path, "Lib/kvazaar_lib.lib"));
 			AddStaticLibraryIfExists(Path.Combine(openhevc_base_path, "Lib/LibOpenHevcWrapper.lib"));
 			AddStaticLibraryIfExists(Path.Combine(fpng_base_path, "Lib/fpng.lib"));
+			AddStaticLibraryIfExists(Path.Combine(lz4_base_path, "Lib/lz4.lib"));
+			AddStaticLibraryIfExists(Path.Combine(zstd_base_path, "Lib/zstd_static.lib"));
 			AddStaticLibraryIfExists(Path.Combine(pahocpp_base_path, "Lib/paho-mqttpp3-static.lib"));
 			AddStaticLibraryIfExists(Path.Combine(pahocpp_base_path, "Lib/paho-mqtt3as-static.lib"));
             AddStaticLibraryIfExists(Path.Combine(pahocpp_base_path, "Lib/libssl.lib"));
@@ -49,6 +53,8 @@ public class CiThruS : ModuleRules
 			AddStaticLibraryIfExists(Path.Combine(kvazaar_base_path, "Lib/libkvazaar.a"));
 			AddStaticLibraryIfExists(Path.Combine(openhevc_base_path, "Lib/libLibOpenHevcWrapper.a"));
 			AddStaticLibraryIfExists(Path.Combine(fpng_base_path, "Lib/fpng.a"));
+			AddStaticLibraryIfExists(Path.Combine(lz4_base_path, "Lib/liblz4.a"));
+			AddStaticLibraryIfExists(Path.Combine(zstd_base_path, "Lib/libzstd.a"));
 			AddStaticLibraryIfExists(Path.Combine(pahocpp_base_path, "Lib/libpaho-mqttpp3.a"));
 			AddStaticLibraryIfExists(Path.Combine(pahocpp_base_path, "Lib/libpaho-mqtt3as.a"));
 			PublicDependencyModuleNames.Add("OpenSSL");
@@ -36,3 +36,42 @@ bool CameraUtility::GetViewportDimensions(UWorld* world, FVector2D& viewportSize
 	}
 	
 }
+
+bool CameraUtility::GetProjectedBounds(const std::vector<FVector>& points, const FTransform& cameraTransform, const float& horizontalFov, const float& aspectRatio, FBox2D& bounds)
+{
+	// Points closer than this are clamped to it so that points behind the camera still extend the bounds towards the edge of the image
+	static const float MIN_DEPTH = 1.0f;
+
+	const float tanInverse = 1.0f / tan(FMath::DegreesToRadians(horizontalFov / 2.0f));
+
+	bool anyInFront = false;
+
+	bounds = FBox2D(ForceInit);
+
+	for (const FVector& point : points)
+	{
+		// X is forward, Y is right and Z is up in camera space
+		FVector pointInCameraSpace = cameraTransform.InverseTransformPositionNoScale(point);
+
+		if (pointInCameraSpace.X > 0.0f)
+		{
+			anyInFront = true;
+		}
+
+		float depth = FMath::Max(pointInCameraSpace.X, MIN_DEPTH);
+
+		bounds += FVector2D(
+			0.5f + 0.5f * pointInCameraSpace.Y * tanInverse / depth,
+			0.5f - 0.5f * pointInCameraSpace.Z * tanInverse * aspectRatio / depth);
+	}
+
+	if (!anyInFront || bounds.Max.X < 0.0f || bounds.Min.X > 1.0f || bounds.Max.Y < 0.0f || bounds.Min.Y > 1.0f)
+	{
+		return false;
+	}
+
+	bounds.Min = FVector2D::Max(bounds.Min, FVector2D::ZeroVector);
+	bounds.Max = FVector2D::Min(bounds.Max, FVector2D::UnitVector);
+
+	return true;
+}
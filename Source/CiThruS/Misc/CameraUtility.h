@@ -2,7 +2,14 @@
 
 #include <CoreMinimal.h>
 
+#include <vector>
+
 namespace CameraUtility
 {
 	bool GetViewportDimensions(UWorld* world, FVector2D& viewportSize);
+
+	// Projects world space points into the image of a perspective camera and returns their bounding box in
+	// normalized image coordinates, (0, 0) being the top left corner and (1, 1) the bottom right corner.
+	// Returns false if the bounding box is entirely outside the image or all points are behind the camera
+	bool GetProjectedBounds(const std::vector<FVector>& points, const FTransform& cameraTransform, const float& horizontalFov, const float& aspectRatio, FBox2D& bounds);
 }
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <thread>
+
+// Keeps a steady frame rate by sleeping until the next frame is due. Frames are scheduled from the
+// first frame rather than the previous one, so occasional slow frames don't shift the whole schedule
+class FramePacer
+{
+public:
+	// A frame rate of 0 or less disables pacing
+	FramePacer(const float& frameRate) : frameInterval_(std::chrono::steady_clock::duration::zero()), started_(false)
+	{
+		if (frameRate > 0.0f)
+		{
+			frameInterval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(1.0f / frameRate));
+		}
+	}
+
+	inline void WaitForNextFrame()
+	{
+		if (frameInterval_ == std::chrono::steady_clock::duration::zero())
+		{
+			return;
+		}
+
+		if (!started_)
+		{
+			nextFrameTime_ = std::chrono::steady_clock::now();
+			started_ = true;
+		}
+
+		std::this_thread::sleep_until(nextFrameTime_);
+
+		nextFrameTime_ += frameInterval_;
+	}
+
+protected:
+	std::chrono::steady_clock::duration frameInterval_;
+	std::chrono::steady_clock::time_point nextFrameTime_;
+	bool started_;
+};
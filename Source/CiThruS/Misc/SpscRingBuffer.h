@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+
+// Bounded lock-free queue for passing items from exactly one producer thread to exactly one consumer thread
+template <typename T>
+class SpscRingBuffer
+{
+	// Template implementation must be in the header file
+
+public:
+	// One slot is always left empty to tell a full buffer apart from an empty one
+	SpscRingBuffer(const size_t& capacity) : buffer_(capacity + 1), head_(0), tail_(0) { }
+
+	// May only be called from the producer thread. Returns false if the buffer is full
+	bool TryPush(const T& item)
+	{
+		const size_t tail = tail_.load(std::memory_order_relaxed);
+		const size_t nextTail = (tail + 1) % buffer_.size();
+
+		if (nextTail == head_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		buffer_[tail] = item;
+		tail_.store(nextTail, std::memory_order_release);
+
+		return true;
+	}
+
+	// May only be called from the consumer thread. Returns false if the buffer is empty
+	bool TryPop(T& item)
+	{
+		const size_t head = head_.load(std::memory_order_relaxed);
+
+		if (head == tail_.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item = buffer_[head];
+		head_.store((head + 1) % buffer_.size(), std::memory_order_release);
+
+		return true;
+	}
+
+protected:
+	std::vector<T> buffer_;
+
+	// On separate cache lines so that the producer and consumer don't slow each other down
+	alignas(64) std::atomic<size_t> head_;
+	alignas(64) std::atomic<size_t> tail_;
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#if __has_include("LZ4/Include/lz4.h")
+#define CITHRUS_LZ4_AVAILABLE
+#include "LZ4/Include/lz4.h"
+#else
+#pragma message (__FILE__ ": warning: LZ4 not found, LZ4 compression is unavailable")
+#endif // __has_include(...)
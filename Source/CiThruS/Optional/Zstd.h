@@ -0,0 +1,8 @@
+#pragma once
+
+#if __has_include("Zstd/Include/zstd.h")
+#define CITHRUS_ZSTD_AVAILABLE
+#include "Zstd/Include/zstd.h"
+#else
+#pragma message (__FILE__ ": warning: zstd not found, zstd compression is unavailable")
+#endif // __has_include(...)
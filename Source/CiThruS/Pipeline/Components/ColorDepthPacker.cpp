@@ -0,0 +1,216 @@
+#include "ColorDepthPacker.h"
+#include "DepthToYuvConverter.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+ColorDepthPacker::ColorDepthPacker(const uint16_t& frameWidth, const uint16_t& frameHeight, const ColorDepthLayout& layout)
+	: inputFrameWidth_(frameWidth), inputFrameHeight_(frameHeight), layout_(layout)
+{
+	if (inputFrameWidth_ % 4 != 0 || inputFrameHeight_ % 4 != 0)
+	{
+		throw std::runtime_error("The width and height of packed color and depth data must be divisible by 4");
+	}
+
+	std::pair<uint16_t, uint16_t> packedResolution = GetPackedResolution(frameWidth, frameHeight, layout);
+
+	outputFrameWidth_ = packedResolution.first;
+	outputFrameHeight_ = packedResolution.second;
+
+	reducedRowsPerHalf_ = (inputFrameHeight_ / 2 + 1) / 2;
+
+	const uint32_t outputLumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+	outputSize_ = outputLumaSize * 3 / 2;
+	outputData_ = new uint8_t[outputSize_];
+
+	// The parts of the image that are not overwritten during processing stay black/gray
+	std::fill_n(outputData_, outputLumaSize, 0);
+	std::fill_n(outputData_ + outputLumaSize, outputLumaSize / 2, DepthToYuvConverter::DEPTH_CHROMA);
+
+	GetInputPin<0>().Initialize(this, "yuv420");
+	GetInputPin<1>().Initialize(this, "yuv420");
+	GetOutputPin<0>().Initialize(this, "yuv420");
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+ColorDepthPacker::~ColorDepthPacker()
+{
+	delete[] outputData_;
+	outputData_ = nullptr;
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void ColorDepthPacker::Process()
+{
+	const uint8_t* colorData = GetInputPin<0>().GetData();
+	uint32_t colorSize = GetInputPin<0>().GetSize();
+
+	const uint8_t* depthData = GetInputPin<1>().GetData();
+	uint32_t depthSize = GetInputPin<1>().GetSize();
+
+	const uint32_t expectedSize = inputFrameWidth_ * inputFrameHeight_ * 3 / 2;
+
+	if (!colorData || !depthData || colorSize != expectedSize || depthSize != expectedSize)
+	{
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
+
+		return;
+	}
+
+	switch (layout_)
+	{
+	case ColorDepthVertical:
+		PackVertical(colorData, depthData);
+		break;
+
+	case ColorDepthSideBySide:
+		PackSideBySide(colorData, depthData);
+		break;
+
+	case ColorDepthReducedResolution:
+		PackReducedResolution(colorData, depthData);
+		break;
+
+	case ColorDepthChroma:
+		PackChroma(colorData, depthData);
+		break;
+	}
+
+	GetOutputPin<0>().SetData(outputData_);
+	GetOutputPin<0>().SetSize(outputSize_);
+}
+
+void ColorDepthPacker::OnInputPinsConnected()
+{
+	const uint32_t inputLumaSize = inputFrameWidth_ * inputFrameHeight_;
+	const uint32_t outputLumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+	// In these layouts the color planes are contiguous in the packed image, so the component producing
+	// the color image can write it there directly and it doesn't have to be copied
+	if (layout_ == ColorDepthVertical || layout_ == ColorDepthReducedResolution)
+	{
+		GetInputPin<0>().LendPlanes(
+			{
+				{ outputData_, inputLumaSize },
+				{ outputData_ + outputLumaSize, inputLumaSize / 4 },
+				{ outputData_ + outputLumaSize * 5 / 4, inputLumaSize / 4 }
+			});
+	}
+}
+
+std::pair<uint16_t, uint16_t> ColorDepthPacker::GetPackedResolution(const uint16_t& frameWidth, const uint16_t& frameHeight, const ColorDepthLayout& layout)
+{
+	switch (layout)
+	{
+	case ColorDepthVertical:
+		return { frameWidth, frameHeight * 2 };
+
+	case ColorDepthSideBySide:
+		return { frameWidth * 2, frameHeight };
+
+	case ColorDepthReducedResolution:
+	{
+		uint16_t rowsPerHalf = (frameHeight / 2 + 1) / 2;
+
+		// The strip height is rounded up to the nearest integer divisible by eight (HEVC limitation)
+		return { frameWidth, frameHeight + rowsPerHalf + (8 - (rowsPerHalf % 8)) % 8 };
+	}
+
+	case ColorDepthChroma:
+		return { frameWidth, frameHeight };
+	}
+
+	throw std::invalid_argument("Unknown color and depth layout");
+}
+
+void ColorDepthPacker::PackVertical(const uint8_t* color, const uint8_t* depth)
+{
+	const uint32_t inputLumaSize = inputFrameWidth_ * inputFrameHeight_;
+
+	CopyColorPlanes(color);
+
+	// Copy depth Y
+	memcpy(outputData_ + inputLumaSize, depth, inputLumaSize);
+}
+
+void ColorDepthPacker::PackSideBySide(const uint8_t* color, const uint8_t* depth)
+{
+	const uint32_t inputLumaSize = inputFrameWidth_ * inputFrameHeight_;
+	const uint32_t outputLumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+	// Copy Y
+	for (int i = 0; i < inputFrameHeight_; i++)
+	{
+		memcpy(outputData_ + i * outputFrameWidth_, color + i * inputFrameWidth_, inputFrameWidth_);
+		memcpy(outputData_ + i * outputFrameWidth_ + inputFrameWidth_, depth + i * inputFrameWidth_, inputFrameWidth_);
+	}
+
+	// Copy U and V
+	for (int i = 0; i < inputFrameHeight_ / 2; i++)
+	{
+		memcpy(outputData_ + outputLumaSize + i * outputFrameWidth_ / 2, color + inputLumaSize + i * inputFrameWidth_ / 2, inputFrameWidth_ / 2);
+		memcpy(outputData_ + outputLumaSize * 5 / 4 + i * outputFrameWidth_ / 2, color + inputLumaSize * 5 / 4 + i * inputFrameWidth_ / 2, inputFrameWidth_ / 2);
+	}
+}
+
+void ColorDepthPacker::PackReducedResolution(const uint8_t* color, const uint8_t* depth)
+{
+	CopyColorPlanes(color);
+
+	uint8_t* strip = outputData_ + inputFrameWidth_ * inputFrameHeight_;
+
+	DownscaleDepthRows(depth, strip, outputFrameWidth_, 0, reducedRowsPerHalf_);
+	DownscaleDepthRows(depth, strip + inputFrameWidth_ / 2, outputFrameWidth_, reducedRowsPerHalf_, inputFrameHeight_ / 2 - reducedRowsPerHalf_);
+}
+
+void ColorDepthPacker::PackChroma(const uint8_t* color, const uint8_t* depth)
+{
+	const uint32_t inputLumaSize = inputFrameWidth_ * inputFrameHeight_;
+
+	// Copy Y
+	memcpy(outputData_, color, inputLumaSize);
+
+	// Depth replaces U, V stays constant gray
+	DownscaleDepthRows(depth, outputData_ + inputLumaSize, inputFrameWidth_ / 2, 0, inputFrameHeight_ / 2);
+}
+
+void ColorDepthPacker::CopyColorPlanes(const uint8_t* color)
+{
+	// The color image has already been written into the right place in the output
+	if (color == outputData_)
+	{
+		return;
+	}
+
+	const uint32_t inputLumaSize = inputFrameWidth_ * inputFrameHeight_;
+	const uint32_t outputLumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+	// Copy Y
+	memcpy(outputData_, color, inputLumaSize);
+	// Copy U
+	memcpy(outputData_ + outputLumaSize, color + inputLumaSize, inputLumaSize / 4);
+	// Copy V
+	memcpy(outputData_ + outputLumaSize * 5 / 4, color + inputLumaSize * 5 / 4, inputLumaSize / 4);
+}
+
+void ColorDepthPacker::DownscaleDepthRows(const uint8_t* depth, uint8_t* output, const uint32_t& outputStride, const uint16_t& firstRow, const uint16_t& rowCount) const
+{
+	for (int i = 0; i < rowCount; i++)
+	{
+		const uint8_t* topRow = depth + (firstRow + i) * 2 * inputFrameWidth_;
+		const uint8_t* bottomRow = topRow + inputFrameWidth_;
+
+		uint8_t* outputRow = output + i * outputStride;
+
+		for (int j = 0; j < inputFrameWidth_ / 2; j++)
+		{
+			outputRow[j] = (topRow[j * 2] + topRow[j * 2 + 1] + bottomRow[j * 2] + bottomRow[j * 2 + 1] + 2) >> 2;
+		}
+	}
+}
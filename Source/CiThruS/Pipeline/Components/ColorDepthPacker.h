@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineFilter.h"
+
+#include <utility>
+
+enum ColorDepthLayout : uint8_t
+{
+	// Depth below color, the packed frame is twice as tall
+	ColorDepthVertical,
+	// Depth to the right of color, the packed frame is twice as wide
+	ColorDepthSideBySide,
+	// Depth at half resolution in a strip below color. The left half of the strip contains the top
+	// half of the depth image and the right half of the strip contains the bottom half
+	ColorDepthReducedResolution,
+	// Color luma with depth at half resolution in the U plane. The color is grayscale, but the packed
+	// frame is as large as the color frame
+	ColorDepthChroma
+};
+
+// Packs a YUV 4:2:0 color image and the luma of a YUV 4:2:0 depth image into a single YUV 4:2:0 image.
+// Input pin 0 is color, input pin 1 is depth. Both must have the same resolution
+class CITHRUS_API ColorDepthPacker : public PipelineFilter<2, 1>
+{
+public:
+	ColorDepthPacker(const uint16_t& frameWidth, const uint16_t& frameHeight, const ColorDepthLayout& layout);
+	virtual ~ColorDepthPacker();
+
+	virtual void Process() override;
+	virtual void OnInputPinsConnected() override;
+
+	// <width, height> of the packed image
+	static std::pair<uint16_t, uint16_t> GetPackedResolution(const uint16_t& frameWidth, const uint16_t& frameHeight, const ColorDepthLayout& layout);
+
+protected:
+	uint8_t* outputData_;
+	uint32_t outputSize_;
+
+	uint16_t inputFrameWidth_;
+	uint16_t inputFrameHeight_;
+	uint16_t outputFrameWidth_;
+	uint16_t outputFrameHeight_;
+
+	ColorDepthLayout layout_;
+
+	// Depth rows per half of the reduced resolution strip
+	uint16_t reducedRowsPerHalf_;
+
+	void PackVertical(const uint8_t* color, const uint8_t* depth);
+	void PackSideBySide(const uint8_t* color, const uint8_t* depth);
+	void PackReducedResolution(const uint8_t* color, const uint8_t* depth);
+	void PackChroma(const uint8_t* color, const uint8_t* depth);
+
+	// Copies the color planes to the top of the packed image, unless they were already written there directly
+	void CopyColorPlanes(const uint8_t* color);
+
+	// Averages 2x2 blocks of the depth luma plane into a plane with half the width and height
+	void DownscaleDepthRows(const uint8_t* depth, uint8_t* output, const uint32_t& outputStride, const uint16_t& firstRow, const uint16_t& rowCount) const;
+};
@@ -4,7 +4,7 @@
 #include <iostream>
 #include <array>
 
-DepthToYuvConverter::DepthToYuvConverter() : outputData_(nullptr), outputSize_(0)
+DepthToYuvConverter::DepthToYuvConverter() : outputData_(nullptr), outputSize_(0), filledLentChroma_(nullptr)
 {
 	GetInputPin<0>().Initialize(this, { "rgba", "bgra" });
 	GetOutputPin<0>().Initialize(this, "yuv420");
@@ -30,25 +30,55 @@ void DepthToYuvConverter::Process()
 		return;
 	}
 
-	if (outputSize_ != inputSize * 3 / 8)
+	const uint32_t lumaSize = inputSize / 4;
+
+	uint8_t* yOutput;
+
+	// Write directly into memory lent by the next component if possible so that it doesn't have to copy the image
+	if (GetOutputPin<0>().HasLentPlanes({ lumaSize, lumaSize / 4, lumaSize / 4 }))
 	{
-		outputSize_ = inputSize * 3 / 8;
+		const std::vector<OutputPin::LentPlane>& lentPlanes = GetOutputPin<0>().GetLentPlanes();
 
-		delete[] outputData_;
-		outputData_ = new uint8_t[outputSize_];
-		GetOutputPin<0>().SetData(outputData_);
-		GetOutputPin<0>().SetSize(outputSize_);
+		yOutput = lentPlanes[0].data;
+
+		// Fill chrominance with constant gray as it's not needed/used. Nobody else writes into the lent planes,
+		// so this only has to be done once
+		if (filledLentChroma_ != lentPlanes[1].data)
+		{
+			std::fill_n(lentPlanes[1].data, lumaSize / 4, DEPTH_CHROMA);
+			std::fill_n(lentPlanes[2].data, lumaSize / 4, DEPTH_CHROMA);
+
+			filledLentChroma_ = lentPlanes[1].data;
+		}
 
-		// Fill chrominance with constant gray as it's not needed/used
-		std::fill_n(outputData_ + inputSize / 4, inputSize / 8, 127);
+		GetOutputPin<0>().SetSize(inputSize * 3 / 8);
+	}
+	else
+	{
+		if (outputSize_ != inputSize * 3 / 8)
+		{
+			outputSize_ = inputSize * 3 / 8;
+
+			delete[] outputData_;
+			outputData_ = new uint8_t[outputSize_];
+
+			// Fill chrominance with constant gray as it's not needed/used
+			std::fill_n(outputData_ + inputSize / 4, inputSize / 8, DEPTH_CHROMA);
+		}
+
+		yOutput = outputData_;
+
+		GetOutputPin<0>().SetSize(outputSize_);
 	}
 
 	std::transform(
 		reinterpret_cast<const std::array<uint8_t, 4>*>(inputData),
 		reinterpret_cast<const std::array<uint8_t, 4>*>(inputData + inputSize),
-		outputData_,
+		yOutput,
 		[&](const std::array<uint8_t, 4>& input)
 		{
 			return input[3];
 		});
+
+	GetOutputPin<0>().SetData(yOutput);
 }
@@ -11,7 +11,13 @@ public:
 
 	virtual void Process() override;
 
+	// Constant chrominance of the converted depth images, also used by other components that pack depth
+	static constexpr uint8_t DEPTH_CHROMA = 128;
+
 protected:
 	uint8_t* outputData_;
 	uint32_t outputSize_;
+
+	// The lent chroma planes that have already been filled
+	uint8_t* filledLentChroma_;
 };
@@ -1,11 +1,105 @@
 #include "FileSink.h"
+#include "Misc/Debug.h"
 
 #include <filesystem>
+#include <algorithm>
+#include <new>
 
-FileSink::FileSink(const std::string& filePath) : fileHandle_(nullptr)
+#if defined(_WIN32)
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include <io.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <linux/falloc.h>
+#endif
+
+FileSink::FileSink(const std::string& filePath)
+	: fileHandle_(nullptr), bufferSize_(0), directIo_(false), currentBuffer_(nullptr), currentSize_(0), stopWriting_(false), stalls_(0)
 {
 	GetInputPin<0>().Initialize(this);
 
+	OpenFile(filePath);
+}
+
+FileSink::FileSink(const std::string& filePath, const uint32_t& bufferSize, const uint8_t& bufferCount, const uint64_t& preallocateSize, const bool& directIo)
+	: fileHandle_(nullptr), bufferSize_(bufferSize), directIo_(directIo), currentBuffer_(nullptr), currentSize_(0), stopWriting_(false), stalls_(0)
+{
+	if (bufferSize_ == 0 || bufferSize_ % BUFFER_ALIGNMENT != 0)
+	{
+		throw std::invalid_argument("Buffer size must be a non-zero multiple of " + std::to_string(BUFFER_ALIGNMENT));
+	}
+
+	if (bufferCount < 2)
+	{
+		throw std::invalid_argument("At least two buffers are needed so that one can be filled while another is being written");
+	}
+
+	GetInputPin<0>().Initialize(this);
+
+	OpenFile(filePath);
+
+	// Every write is a whole buffer, so there's no need for another layer of buffering
+	setvbuf(fileHandle_, nullptr, _IONBF, 0);
+
+	if (preallocateSize > 0)
+	{
+		Preallocate(preallocateSize);
+	}
+
+	if (directIo_)
+	{
+		SetDirectIo(true);
+	}
+
+	for (int i = 0; i < bufferCount; i++)
+	{
+		buffers_.push_back(static_cast<uint8_t*>(operator new(bufferSize_, std::align_val_t(BUFFER_ALIGNMENT))));
+	}
+
+	freeBuffers_ = buffers_;
+
+	currentBuffer_ = freeBuffers_.back();
+	freeBuffers_.pop_back();
+
+	writerThread_ = std::thread(&FileSink::WriteBuffersAsync, this);
+}
+
+FileSink::~FileSink()
+{
+	if (writerThread_.joinable())
+	{
+		SubmitCurrentBuffer();
+
+		{
+			std::lock_guard<std::mutex> lock(bufferMutex_);
+
+			stopWriting_ = true;
+		}
+
+		writeCv_.notify_one();
+		writerThread_.join();
+	}
+
+	for (uint8_t* buffer : buffers_)
+	{
+		operator delete(buffer, std::align_val_t(BUFFER_ALIGNMENT));
+	}
+
+	buffers_.clear();
+	freeBuffers_.clear();
+
+	currentBuffer_ = nullptr;
+
+	fclose(fileHandle_);
+
+	fileHandle_ = nullptr;
+}
+
+void FileSink::OpenFile(const std::string& filePath)
+{
 	if (std::filesystem::exists(filePath))
 	{
 		if (!std::filesystem::is_regular_file(filePath))
@@ -37,27 +131,138 @@ FileSink::FileSink(const std::string& filePath) : fileHandle_(nullptr)
 	if (fileHandle_ == nullptr)
 	{
 		throw std::logic_error("Failed to open file");
+	}
+}
+
+void FileSink::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	if (!inputData || inputSize == 0)
+	{
+		return;
+	}
+
+	if (bufferSize_ == 0)
+	{
+		fwrite(inputData, 1, inputSize, fileHandle_);
 
 		return;
 	}
+
+	while (inputSize > 0)
+	{
+		uint32_t copySize = std::min(inputSize, bufferSize_ - currentSize_);
+
+		memcpy(currentBuffer_ + currentSize_, inputData, copySize);
+
+		currentSize_ += copySize;
+		inputData += copySize;
+		inputSize -= copySize;
+
+		if (currentSize_ == bufferSize_)
+		{
+			SubmitCurrentBuffer();
+		}
+	}
 }
 
-FileSink::~FileSink()
+void FileSink::SubmitCurrentBuffer()
 {
-	fclose(fileHandle_);
+	std::unique_lock<std::mutex> lock(bufferMutex_);
 
-	fileHandle_ = nullptr;
+	if (currentSize_ > 0)
+	{
+		writeQueue_.push({ currentBuffer_, currentSize_ });
+		writeCv_.notify_one();
+
+		if (freeBuffers_.empty())
+		{
+			stalls_.fetch_add(1, std::memory_order_relaxed);
+
+			freeCv_.wait(lock, [this] { return !freeBuffers_.empty(); });
+		}
+
+		currentBuffer_ = freeBuffers_.back();
+		freeBuffers_.pop_back();
+		currentSize_ = 0;
+	}
 }
 
-void FileSink::Process()
+void FileSink::WriteBuffersAsync()
 {
-	const uint8_t* inputData = GetInputPin<0>().GetData();
-	uint32_t inputSize = GetInputPin<0>().GetSize();
+	while (true)
+	{
+		std::pair<uint8_t*, uint32_t> buffer;
 
-	if (!inputData || inputSize == 0)
+		{
+			std::unique_lock<std::mutex> lock(bufferMutex_);
+
+			writeCv_.wait(lock, [this] { return !writeQueue_.empty() || stopWriting_; });
+
+			// Everything has been written once the queue is empty
+			if (writeQueue_.empty())
+			{
+				return;
+			}
+
+			buffer = writeQueue_.front();
+			writeQueue_.pop();
+		}
+
+		// Only the last buffer can be partial, and direct I/O can't write it
+		if (directIo_ && buffer.second % BUFFER_ALIGNMENT != 0)
+		{
+			SetDirectIo(false);
+		}
+
+		if (fwrite(buffer.first, 1, buffer.second, fileHandle_) != buffer.second)
+		{
+			Debug::Log("Failed to write to file");
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(bufferMutex_);
+
+			freeBuffers_.push_back(buffer.first);
+		}
+
+		freeCv_.notify_one();
+	}
+}
+
+void FileSink::Preallocate(const uint64_t& size)
+{
+	// Reserve the space without changing the file size, since the data is appended to the end of the file
+#if defined(_WIN32)
+	FILE_ALLOCATION_INFO allocationInfo;
+
+	allocationInfo.AllocationSize.QuadPart = size;
+
+	if (!SetFileInformationByHandle(reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fileHandle_))), FileAllocationInfo, &allocationInfo, sizeof(allocationInfo)))
 	{
-		return;
+		Debug::Log("Failed to preallocate file");
+	}
+#elif defined(__linux__)
+	if (fallocate(fileno(fileHandle_), FALLOC_FL_KEEP_SIZE, 0, size) != 0)
+	{
+		Debug::Log("Failed to preallocate file");
+	}
+#endif
+}
+
+void FileSink::SetDirectIo(const bool& enabled)
+{
+#if defined(__linux__)
+	int fileDescriptor = fileno(fileHandle_);
+	int flags = fcntl(fileDescriptor, F_GETFL);
+
+	if (flags == -1 || fcntl(fileDescriptor, F_SETFL, enabled ? (flags | O_DIRECT) : (flags & ~O_DIRECT)) == -1)
+	{
+		Debug::Log("Failed to change direct I/O mode");
 	}
+#endif
 
-	fwrite(inputData, 1, inputSize, fileHandle_);
+	directIo_ = enabled;
 }
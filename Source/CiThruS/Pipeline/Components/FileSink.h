@@ -6,17 +6,62 @@
 #include <string>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <vector>
+#include <atomic>
 #include <stdio.h>
 
 // Records generic data into files
 class CITHRUS_API FileSink : public PipelineSink<1>
 {
 public:
+	// Writes synchronously through the standard library's buffering
 	FileSink(const std::string& filePath);
+
+	// Gathers the data into bufferCount large buffers which are written on a background thread, so that
+	// the pipeline only waits for the disk if all buffers are full. preallocateSize reserves disk space
+	// for the file up front to avoid fragmentation and metadata updates while recording. directIo bypasses
+	// the operating system's page cache (Linux only)
+	FileSink(const std::string& filePath, const uint32_t& bufferSize, const uint8_t& bufferCount = 4, const uint64_t& preallocateSize = 0, const bool& directIo = false);
+
 	virtual ~FileSink();
 
 	virtual void Process() override;
 
+	// How many times the pipeline had to wait for the writer thread
+	inline uint64_t GetStallCount() const { return stalls_.load(std::memory_order_relaxed); }
+
 protected:
+	// Direct I/O requires buffers and writes aligned to the storage block size
+	static constexpr uint32_t BUFFER_ALIGNMENT = 4096;
+
 	FILE* fileHandle_;
+
+	uint32_t bufferSize_;
+	bool directIo_;
+
+	std::vector<uint8_t*> buffers_;
+	std::vector<uint8_t*> freeBuffers_;
+	std::queue<std::pair<uint8_t*, uint32_t>> writeQueue_;
+
+	uint8_t* currentBuffer_;
+	uint32_t currentSize_;
+
+	std::mutex bufferMutex_;
+	std::condition_variable writeCv_;
+	std::condition_variable freeCv_;
+
+	bool stopWriting_;
+	std::thread writerThread_;
+
+	std::atomic<uint64_t> stalls_;
+
+	void OpenFile(const std::string& filePath);
+
+	void SubmitCurrentBuffer();
+	void WriteBuffersAsync();
+
+	void Preallocate(const uint64_t& size);
+	void SetDirectIo(const bool& enabled);
 };
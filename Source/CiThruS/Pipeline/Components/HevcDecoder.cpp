@@ -55,6 +55,10 @@ void HevcDecoder::Process()
 
     if (!inputData || inputSize == 0)
     {
+        // Don't leave the previous frame in the output or it would be processed again
+        GetOutputPin<0>().SetData(nullptr);
+        GetOutputPin<0>().SetSize(0);
+
         return;
     }
 
@@ -68,6 +72,9 @@ void HevcDecoder::Process()
         outputData_ = nullptr;
         outputSize_ = 0;
 
+        GetOutputPin<0>().SetData(outputData_);
+        GetOutputPin<0>().SetSize(outputSize_);
+
         return;
     }
 
@@ -0,0 +1,50 @@
+#include "HevcEncoderWithRoi.h"
+#include "RoiMapGenerator.h"
+#include "Misc/Debug.h"
+
+HevcEncoderWithRoi::HevcEncoderWithRoi(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& threadCount, const uint8_t& qp, const uint8_t& wpp, const uint8_t& owf, const HevcEncoderPreset& preset)
+	: HevcEncoderBase(frameWidth, frameHeight, threadCount, qp, wpp, owf, preset, 1, 1, true)
+{
+	std::pair<uint16_t, uint16_t> mapResolution = RoiMapGenerator::GetMapResolution(frameWidth, frameHeight);
+
+	roiMapWidth_ = mapResolution.first;
+	roiMapHeight_ = mapResolution.second;
+
+	GetInputPin<0>().Initialize(this, "yuv420");
+	GetInputPin<1>().Initialize(this, "binary");
+	GetOutputPin<0>().Initialize(this, "hevc");
+}
+
+HevcEncoderWithRoi::~HevcEncoderWithRoi()
+{
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void HevcEncoderWithRoi::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	const uint8_t* roiData = GetInputPin<1>().GetData();
+	uint32_t roiSize = GetInputPin<1>().GetSize();
+
+	if (!inputData || inputSize == 0)
+	{
+		// Don't leave the previous frame in the output or it would be sent again
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
+
+		return;
+	}
+
+	if (!roiData || roiSize != roiMapWidth_ * roiMapHeight_)
+	{
+		roiData = nullptr;
+	}
+
+	EncodeInternal(inputData, reinterpret_cast<const int8_t*>(roiData), roiMapWidth_, roiMapHeight_);
+
+	GetOutputPin<0>().SetData(outputData_);
+	GetOutputPin<0>().SetSize(outputSize_);
+}
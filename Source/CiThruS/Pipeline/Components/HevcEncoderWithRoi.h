@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineFilter.h"
+#include "Pipeline/Internal/HevcEncoderBase.h"
+
+// Encodes YUV 4:2:0 data into HEVC video using Kvazaar with a region of interest map from RoiMapGenerator.
+// Input pin 0 is the YUV 4:2:0 image, input pin 1 is the map. Frames without a valid map are encoded without delta QPs
+class CITHRUS_API HevcEncoderWithRoi : public PipelineFilter<2, 1>, protected HevcEncoderBase
+{
+public:
+	HevcEncoderWithRoi(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& threadCount, const uint8_t& qp, const uint8_t& wpp, const uint8_t& owf, const HevcEncoderPreset& preset = HevcPresetNone);
+	virtual ~HevcEncoderWithRoi();
+
+	virtual void Process() override;
+
+protected:
+	uint16_t roiMapWidth_;
+	uint16_t roiMapHeight_;
+};
@@ -0,0 +1,105 @@
+#include "HevcFileSource.h"
+
+#include <stdexcept>
+
+HevcFileSource::HevcFileSource(const std::string& filePath, const float& frameRate, const bool& loop)
+	: file_(filePath), accessUnitIndex_(0), loop_(loop), pacer_(frameRate)
+{
+	FindAccessUnits();
+
+	GetOutputPin<0>().Initialize(this, "hevc");
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+HevcFileSource::~HevcFileSource()
+{
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void HevcFileSource::Process()
+{
+	if (loop_ && accessUnitIndex_ == GetAccessUnitCount())
+	{
+		accessUnitIndex_ = 0;
+	}
+
+	if (accessUnitIndex_ >= GetAccessUnitCount())
+	{
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
+
+		return;
+	}
+
+	pacer_.WaitForNextFrame();
+
+	const uint64_t start = accessUnitOffsets_[accessUnitIndex_];
+	const uint64_t end = accessUnitOffsets_[accessUnitIndex_ + 1];
+
+	accessUnitIndex_++;
+
+	GetOutputPin<0>().SetData(file_.GetData() + start);
+	GetOutputPin<0>().SetSize(static_cast<uint32_t>(end - start));
+}
+
+void HevcFileSource::FindAccessUnits()
+{
+	const uint8_t* data = file_.GetData();
+	const uint64_t size = file_.GetSize();
+
+	// Whether the current access unit already contains a picture
+	bool hasPicture = false;
+
+	for (uint64_t i = 0; i + 4 < size; i++)
+	{
+		if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1)
+		{
+			continue;
+		}
+
+		// Include the extra zero of a four byte start code
+		const uint64_t nalStart = (i > 0 && data[i - 1] == 0) ? i - 1 : i;
+		const uint8_t nalType = (data[i + 3] >> 1) & 0x3F;
+
+		bool startsAccessUnit;
+
+		if (nalType < 32)
+		{
+			// Slices of a new picture have first_slice_segment_in_pic_flag set
+			const bool firstSlice = i + 5 < size && (data[i + 5] & 0x80) != 0;
+
+			startsAccessUnit = hasPicture && firstSlice;
+			hasPicture = true;
+		}
+		else
+		{
+			// Parameter sets, access unit delimiters and prefix SEI come before the picture they belong to
+			startsAccessUnit = hasPicture && (nalType <= 35 || nalType == 39 || (nalType >= 41 && nalType <= 44) || (nalType >= 48 && nalType <= 55));
+
+			if (startsAccessUnit)
+			{
+				hasPicture = false;
+			}
+		}
+
+		if (accessUnitOffsets_.empty())
+		{
+			accessUnitOffsets_.push_back(nalStart);
+		}
+		else if (startsAccessUnit)
+		{
+			accessUnitOffsets_.push_back(nalStart);
+		}
+
+		i += 2;
+	}
+
+	if (accessUnitOffsets_.empty())
+	{
+		throw std::runtime_error("File does not contain HEVC data");
+	}
+
+	accessUnitOffsets_.push_back(size);
+}
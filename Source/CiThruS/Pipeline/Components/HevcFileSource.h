@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineSource.h"
+#include "Pipeline/Internal/MappedFile.h"
+#include "Misc/FramePacer.h"
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <vector>
+
+// Plays back a raw Annex B HEVC stream, such as one recorded by a FileSink after HevcEncoder, one access
+// unit at a time. The data is output directly from the memory mapped file without copying
+class CITHRUS_API HevcFileSource : public PipelineSource<1>
+{
+public:
+	// frameRate 0 outputs access units as fast as they are processed
+	HevcFileSource(const std::string& filePath, const float& frameRate = 0.0f, const bool& loop = false);
+	virtual ~HevcFileSource();
+
+	virtual void Process() override;
+
+	inline uint64_t GetAccessUnitCount() const { return accessUnitOffsets_.size() - 1; }
+
+protected:
+	MappedFile file_;
+
+	// Start offset of each access unit followed by the end of the last one
+	std::vector<uint64_t> accessUnitOffsets_;
+	uint64_t accessUnitIndex_;
+
+	bool loop_;
+
+	FramePacer pacer_;
+
+	void FindAccessUnits();
+};
@@ -0,0 +1,25 @@
+#include "HevcMp4Recorder.h"
+
+HevcMp4Recorder::HevcMp4Recorder(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight, const float& frameRate, const uint32_t& maxFragmentFrames)
+	: Mp4MuxerBase(filePath, frameWidth, frameHeight, frameRate, maxFragmentFrames)
+{
+	GetInputPin<0>().Initialize(this, "hevc");
+}
+
+HevcMp4Recorder::~HevcMp4Recorder()
+{
+
+}
+
+void HevcMp4Recorder::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	if (!inputData || inputSize == 0)
+	{
+		return;
+	}
+
+	AddVideoFrame(inputData, inputSize);
+}
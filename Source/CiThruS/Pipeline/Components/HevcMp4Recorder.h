@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Pipeline/Internal/PipelineSink.h"
+#include "Pipeline/Internal/Mp4MuxerBase.h"
+
+#include <string>
+
+// Records HEVC video into a seekable fragmented MP4 file
+class CITHRUS_API HevcMp4Recorder : public PipelineSink<1>, protected Mp4MuxerBase
+{
+public:
+	HevcMp4Recorder(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight, const float& frameRate, const uint32_t& maxFragmentFrames = 120);
+	virtual ~HevcMp4Recorder();
+
+	virtual void Process() override;
+};
@@ -0,0 +1,39 @@
+#include "HevcMp4RecorderWithMetadata.h"
+
+HevcMp4RecorderWithMetadata::HevcMp4RecorderWithMetadata(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight, const float& frameRate, const uint32_t& maxFragmentFrames)
+	: Mp4MuxerBase(filePath, frameWidth, frameHeight, frameRate, maxFragmentFrames)
+{
+	GetInputPin<0>().Initialize(this, "hevc");
+	GetInputPin<1>().Initialize(this);
+}
+
+HevcMp4RecorderWithMetadata::~HevcMp4RecorderWithMetadata()
+{
+
+}
+
+void HevcMp4RecorderWithMetadata::OnInputPinsConnected()
+{
+	EnableMetadataTrack(GetInputPin<1>().GetFormat() == "csv" ? "text/csv" : "application/octet-stream");
+}
+
+void HevcMp4RecorderWithMetadata::Process()
+{
+	const uint8_t* videoData = GetInputPin<0>().GetData();
+	uint32_t videoSize = GetInputPin<0>().GetSize();
+
+	const uint8_t* metadata = GetInputPin<1>().GetData();
+	uint32_t metadataSize = GetInputPin<1>().GetSize();
+
+	// The metadata belongs to the frame that was just given to the encoder, so it's queued before the encoder's
+	// output is muxed in case the encoder has no delay
+	if (metadata && metadataSize != 0)
+	{
+		AddMetadata(metadata, metadataSize);
+	}
+
+	if (videoData && videoSize != 0)
+	{
+		AddVideoFrame(videoData, videoSize);
+	}
+}
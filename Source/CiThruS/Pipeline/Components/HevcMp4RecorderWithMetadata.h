@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Pipeline/Internal/PipelineSink.h"
+#include "Pipeline/Internal/Mp4MuxerBase.h"
+
+#include <string>
+
+// Records HEVC video into a seekable fragmented MP4 file along with per-frame metadata in a timed metadata track.
+// Input pin 0 is the video, input pin 1 is the metadata of each frame in any format, for example from CsvLogger.
+// The metadata is queued until the encoder outputs the frame it belongs to, so the nth metadata sample is timed to
+// the nth video frame as long as the metadata doesn't skip frames
+class CITHRUS_API HevcMp4RecorderWithMetadata : public PipelineSink<2>, protected Mp4MuxerBase
+{
+public:
+	HevcMp4RecorderWithMetadata(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight, const float& frameRate, const uint32_t& maxFragmentFrames = 120);
+	virtual ~HevcMp4RecorderWithMetadata();
+
+	virtual void Process() override;
+
+	virtual void OnInputPinsConnected() override;
+};
@@ -0,0 +1,44 @@
+#include "HevcStatisticsProbe.h"
+
+HevcStatisticsProbe::HevcStatisticsProbe() : byteCount_(0), nalUnitCount_(0)
+{
+	GetInputPin<0>().Initialize(this, "hevc");
+	GetOutputPin<0>().Initialize(this, "hevc");
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+HevcStatisticsProbe::~HevcStatisticsProbe()
+{
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void HevcStatisticsProbe::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	GetOutputPin<0>().SetData(inputData);
+	GetOutputPin<0>().SetSize(inputSize);
+
+	if (!inputData)
+	{
+		return;
+	}
+
+	// Each NAL unit begins with a 00 00 01 start code (the four byte version ends the same way)
+	uint64_t nalUnits = 0;
+
+	for (uint32_t i = 2; i < inputSize; i++)
+	{
+		if (inputData[i] == 1 && inputData[i - 1] == 0 && inputData[i - 2] == 0)
+		{
+			nalUnits++;
+		}
+	}
+
+	byteCount_.fetch_add(inputSize, std::memory_order_relaxed);
+	nalUnitCount_.fetch_add(nalUnits, std::memory_order_relaxed);
+}
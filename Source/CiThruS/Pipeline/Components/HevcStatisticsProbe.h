@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineFilter.h"
+
+#include <atomic>
+
+// Passes HEVC data through unmodified while counting the bytes and NAL units that go through it.
+// The counters can be read from other threads while the pipeline is running
+class CITHRUS_API HevcStatisticsProbe : public PipelineFilter<1, 1>
+{
+public:
+	HevcStatisticsProbe();
+	virtual ~HevcStatisticsProbe();
+
+	virtual void Process() override;
+
+	inline uint64_t GetByteCount() const { return byteCount_.load(std::memory_order_relaxed); }
+	inline uint64_t GetNalUnitCount() const { return nalUnitCount_.load(std::memory_order_relaxed); }
+
+protected:
+	std::atomic<uint64_t> byteCount_;
+	std::atomic<uint64_t> nalUnitCount_;
+};
@@ -48,6 +48,12 @@ public:
 				return;
 			}
 
+			// The input has already been written into the right place in the output
+			if (inputData == outputData_ + frameSize * i)
+			{
+				return;
+			}
+
 			// Copy Y
 			memcpy(outputData_ + frameSize * i, inputData, frameSize);
 			// Copy U
@@ -57,6 +63,22 @@ public:
 		});
 	}
 
+	virtual void OnInputPinsConnected() override
+	{
+		const int frameSize = inputFrameWidth_ * inputFrameHeight_;
+
+		// Let the components producing the inputs write them directly into the concatenated image so that they don't have to be copied
+		TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
+		{
+			this->template GetInputPin<i>().LendPlanes(
+				{
+					{ outputData_ + frameSize * i, static_cast<uint32_t>(frameSize) },
+					{ outputData_ + frameSize / 4 * i + frameSize * NInputs, static_cast<uint32_t>(frameSize / 4) },
+					{ outputData_ + frameSize / 4 * i + frameSize * 5 / 4 * NInputs, static_cast<uint32_t>(frameSize / 4) }
+				});
+		});
+	}
+
 protected:
 	uint8_t* outputData_;
 
@@ -0,0 +1,136 @@
+#include "MosaicPacker.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+MosaicPacker::MosaicPacker(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& imageCount)
+	: inputFrameWidth_(frameWidth), inputFrameHeight_(frameHeight), imageCount_(imageCount)
+{
+	if (imageCount_ == 0)
+	{
+		throw std::invalid_argument("A mosaic must contain at least one image");
+	}
+
+	if (inputFrameWidth_ % 2 != 0 || inputFrameHeight_ % 2 != 0)
+	{
+		throw std::runtime_error("The width and height of YUV 4:2:0 data must be divisible by 2");
+	}
+
+	gridColumns_ = GetGridSize(imageCount_).first;
+
+	std::pair<uint16_t, uint16_t> cellResolution = GetCellResolution(frameWidth, frameHeight, imageCount);
+	std::pair<uint16_t, uint16_t> packedResolution = GetPackedResolution(frameWidth, frameHeight, imageCount);
+
+	cellWidth_ = cellResolution.first;
+	cellHeight_ = cellResolution.second;
+	outputFrameWidth_ = packedResolution.first;
+	outputFrameHeight_ = packedResolution.second;
+
+	const uint32_t outputLumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+	outputSize_ = outputLumaSize * 3 / 2;
+	outputData_ = new uint8_t[outputSize_];
+
+	// The parts of the image that are not overwritten during processing stay black
+	std::fill_n(outputData_, outputLumaSize, 0);
+	std::fill_n(outputData_ + outputLumaSize, outputLumaSize / 2, CHROMA_MID);
+
+	GetInputPin<0>().Initialize(this, "yuv420");
+	GetOutputPin<0>().Initialize(this, "yuv420");
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+MosaicPacker::~MosaicPacker()
+{
+	delete[] outputData_;
+	outputData_ = nullptr;
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void MosaicPacker::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	const uint32_t frameLumaSize = inputFrameWidth_ * inputFrameHeight_;
+	const uint32_t inputLumaSize = frameLumaSize * imageCount_;
+
+	if (!inputData || inputSize != inputLumaSize * 3 / 2)
+	{
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
+
+		return;
+	}
+
+	const uint32_t outputLumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+	for (int i = 0; i < imageCount_; i++)
+	{
+		const uint32_t cellX = (i % gridColumns_) * cellWidth_;
+		const uint32_t cellY = (i / gridColumns_) * cellHeight_;
+
+		// Copy Y
+		CopyPlane(
+			inputData + frameLumaSize * i,
+			outputData_ + cellY * outputFrameWidth_ + cellX,
+			inputFrameWidth_, inputFrameHeight_, outputFrameWidth_);
+		// Copy U
+		CopyPlane(
+			inputData + inputLumaSize + frameLumaSize / 4 * i,
+			outputData_ + outputLumaSize + cellY / 2 * outputFrameWidth_ / 2 + cellX / 2,
+			inputFrameWidth_ / 2, inputFrameHeight_ / 2, outputFrameWidth_ / 2);
+		// Copy V
+		CopyPlane(
+			inputData + inputLumaSize * 5 / 4 + frameLumaSize / 4 * i,
+			outputData_ + outputLumaSize * 5 / 4 + cellY / 2 * outputFrameWidth_ / 2 + cellX / 2,
+			inputFrameWidth_ / 2, inputFrameHeight_ / 2, outputFrameWidth_ / 2);
+	}
+
+	GetOutputPin<0>().SetData(outputData_);
+	GetOutputPin<0>().SetSize(outputSize_);
+}
+
+std::pair<uint8_t, uint8_t> MosaicPacker::GetGridSize(const uint8_t& imageCount)
+{
+	// As square as possible
+	uint8_t columns = static_cast<uint8_t>(std::ceil(std::sqrt(static_cast<float>(imageCount))));
+	uint8_t rows = (imageCount + columns - 1) / columns;
+
+	return { columns, rows };
+}
+
+std::pair<uint16_t, uint16_t> MosaicPacker::GetCellResolution(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& imageCount)
+{
+	uint16_t cellWidth = (frameWidth + CELL_ALIGNMENT - 1) / CELL_ALIGNMENT * CELL_ALIGNMENT;
+	uint16_t cellHeight = (frameHeight + CELL_ALIGNMENT - 1) / CELL_ALIGNMENT * CELL_ALIGNMENT;
+
+	// A single column doesn't need to be split into tile columns
+	if (GetGridSize(imageCount).first > 1)
+	{
+		cellWidth = std::max(cellWidth, MIN_TILE_WIDTH);
+	}
+
+	return { cellWidth, cellHeight };
+}
+
+std::pair<uint16_t, uint16_t> MosaicPacker::GetPackedResolution(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& imageCount)
+{
+	std::pair<uint8_t, uint8_t> gridSize = GetGridSize(imageCount);
+	std::pair<uint16_t, uint16_t> cellResolution = GetCellResolution(frameWidth, frameHeight, imageCount);
+
+	return { cellResolution.first * gridSize.first, cellResolution.second * gridSize.second };
+}
+
+void MosaicPacker::CopyPlane(const uint8_t* input, uint8_t* output, const uint16_t& width, const uint16_t& height, const uint32_t& outputStride)
+{
+	for (int i = 0; i < height; i++)
+	{
+		memcpy(output + i * outputStride, input + i * width, width);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineFilter.h"
+
+#include <utility>
+
+// Arranges vertically concatenated YUV 4:2:0 images (for example from a RenderTargetReader with multiple
+// render targets) into a grid. The grid cells are aligned to HEVC coding tree units so that each image
+// can be encoded as its own tile and extracted from the stream by the receiver. Images are placed
+// row by row starting from the top left cell, unused cells and padding are black
+class CITHRUS_API MosaicPacker : public PipelineFilter<1, 1>
+{
+public:
+	MosaicPacker(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& imageCount);
+	virtual ~MosaicPacker();
+
+	virtual void Process() override;
+
+	// <columns, rows> of the grid
+	static std::pair<uint8_t, uint8_t> GetGridSize(const uint8_t& imageCount);
+	// <width, height> of a single grid cell
+	static std::pair<uint16_t, uint16_t> GetCellResolution(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& imageCount);
+	// <width, height> of the packed image
+	static std::pair<uint16_t, uint16_t> GetPackedResolution(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& imageCount);
+
+protected:
+	// Size of the largest HEVC coding tree unit
+	static constexpr uint16_t CELL_ALIGNMENT = 64;
+	// HEVC tile columns must be at least this wide
+	static constexpr uint16_t MIN_TILE_WIDTH = 256;
+
+	static constexpr uint8_t CHROMA_MID = 128;
+
+	uint8_t* outputData_;
+	uint32_t outputSize_;
+
+	uint16_t inputFrameWidth_;
+	uint16_t inputFrameHeight_;
+	uint8_t imageCount_;
+
+	uint8_t gridColumns_;
+
+	uint16_t cellWidth_;
+	uint16_t cellHeight_;
+	uint16_t outputFrameWidth_;
+	uint16_t outputFrameHeight_;
+
+	static void CopyPlane(const uint8_t* input, uint8_t* output, const uint16_t& width, const uint16_t& height, const uint32_t& outputStride);
+};
@@ -2,10 +2,23 @@
 #include "Misc/Debug.h"
 
 #include <filesystem>
+#include <stdexcept>
 
-PngRecorder::PngRecorder(const std::string& directory, const uint16_t& imageWidth, const uint16_t& imageHeight)
-	: imageWidth_(imageWidth), imageHeight_(imageHeight), directory_(directory), frameIndex_(0)
+PngRecorder::PngRecorder(const std::string& directory, const uint16_t& imageWidth, const uint16_t& imageHeight,
+	const uint8_t& workerCount, const uint16_t& queueCapacity, const bool& dropWhenFull)
+	: imageWidth_(imageWidth), imageHeight_(imageHeight), directory_(directory), frameIndex_(0), dropWhenFull_(dropWhenFull),
+	freeSlots_(queueCapacity), queuedImages_(0), writtenFrames_(0), droppedFrames_(0), failedFrames_(0), stalls_(0)
 {
+	if (workerCount == 0)
+	{
+		throw std::invalid_argument("PngRecorder needs at least one worker thread");
+	}
+
+	if (queueCapacity == 0)
+	{
+		throw std::invalid_argument("PngRecorder queue capacity cannot be 0");
+	}
+
 	GetInputPin<0>().Initialize(this, "rgba");
 
 	if (!std::filesystem::exists(directory_))
@@ -16,11 +29,43 @@ PngRecorder::PngRecorder(const std::string& directory, const uint16_t& imageWidt
 	{
 		throw std::invalid_argument("Given path is a file, not a directory");
 	}
+
+#ifdef CITHRUS_FPNG_AVAILABLE
+	fpng::fpng_init();
+#endif // CITHRUS_FPNG_AVAILABLE
+
+	for (int i = 0; i < workerCount; i++)
+	{
+		workers_.push_back(std::thread(&PngRecorder::WriteImagesAsync, this));
+	}
 }
 
 PngRecorder::~PngRecorder()
 {
-	
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+
+		// Each worker stops when it gets an empty entry, which only happens after the actual images have been written
+		for (size_t i = 0; i < workers_.size(); i++)
+		{
+			queue_.push({ nullptr, 0, 0 });
+		}
+	}
+
+	queuedImages_.release(workers_.size());
+
+	for (std::thread& worker : workers_)
+	{
+		worker.join();
+	}
+
+	for (uint8_t* buffer : buffers_)
+	{
+		delete[] buffer;
+	}
+
+	buffers_.clear();
+	freeBuffers_.clear();
 }
 
 void PngRecorder::Process()
@@ -33,11 +78,101 @@ void PngRecorder::Process()
 		return;
 	}
 
-	std::string fileName = directory_ + (directory_[directory_.size() - 1] == '/' ? "" : "/") + std::to_string(frameIndex_) + ".png";
+	// The index is used up even if the image is dropped so that the gap is visible in the file names
+	const uint64_t frameIndex = frameIndex_;
+
+	frameIndex_++;
+
+	if (!freeSlots_.try_acquire())
+	{
+		if (dropWhenFull_)
+		{
+			droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+
+			return;
+		}
+
+		stalls_.fetch_add(1, std::memory_order_relaxed);
+		freeSlots_.acquire();
+	}
+
+	uint8_t* buffer = nullptr;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+
+		if (!freeBuffers_.empty())
+		{
+			buffer = freeBuffers_.back();
+			freeBuffers_.pop_back();
+		}
+	}
+
+	// Buffers are only allocated when all existing ones are in use, so a queue that the workers
+	// keep up with only ever needs a few of them instead of queueCapacity full images
+	if (!buffer)
+	{
+		buffer = new uint8_t[imageWidth_ * imageHeight_ * 4];
+		buffers_.push_back(buffer);
+	}
+
+	memcpy(buffer, inputData, inputSize);
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+
+		queue_.push({ buffer, inputSize, frameIndex });
+	}
+
+	queuedImages_.release();
+}
+
+void PngRecorder::WriteImagesAsync()
+{
+	while (true)
+	{
+		queuedImages_.acquire();
+
+		PngBufferData image;
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex_);
+
+			image = queue_.front();
+			queue_.pop();
+		}
+
+		if (!image.data)
+		{
+			return;
+		}
+
+		bool success = false;
 
 #ifdef CITHRUS_FPNG_AVAILABLE
-	fpng::fpng_encode_image_to_file(fileName.data(), inputData, imageWidth_, imageHeight_, 4, 0);
+		success = fpng::fpng_encode_image_to_file(GetFileName(image.frameIndex).data(), image.data, imageWidth_, imageHeight_, 4, 0);
 #endif // CITHRUS_FPNG_AVAILABLE
 
-	frameIndex_++;
+		if (success)
+		{
+			writtenFrames_.fetch_add(1, std::memory_order_relaxed);
+		}
+		else
+		{
+			failedFrames_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex_);
+
+			freeBuffers_.push_back(image.data);
+		}
+
+		freeSlots_.release();
+	}
+}
+
+std::string PngRecorder::GetFileName(const uint64_t& frameIndex) const
+{
+	return directory_ + (directory_[directory_.size() - 1] == '/' ? "" : "/") + std::to_string(frameIndex) + ".png";
 }
@@ -9,18 +9,31 @@
 #include <thread>
 #include <mutex>
 #include <queue>
-#include <array>
+#include <vector>
+#include <atomic>
 #include <semaphore>
 
-// Records RGBA images into PNG files using fpng
+// Records RGBA images into PNG files using fpng. Images are encoded and written on a pool of worker
+// threads so that the pipeline doesn't have to wait for them. Each image is still named after the
+// order in which it was received, but the files may be finished out of order
 class CITHRUS_API PngRecorder : public PipelineSink<1>
 {
 public:
-	PngRecorder(const std::string& directory, const uint16_t& imageWidth, const uint16_t& imageHeight);
+	// queueCapacity is the maximum number of images waiting to be encoded. When the queue is full,
+	// the pipeline waits for a worker to catch up unless dropWhenFull is set, in which case the image is skipped
+	PngRecorder(const std::string& directory, const uint16_t& imageWidth, const uint16_t& imageHeight,
+		const uint8_t& workerCount = 4, const uint16_t& queueCapacity = 16, const bool& dropWhenFull = false);
+	// Waits for all queued images to be written
 	virtual ~PngRecorder();
 
 	virtual void Process() override;
 
+	inline uint64_t GetWrittenFrameCount() const { return writtenFrames_.load(std::memory_order_relaxed); }
+	inline uint64_t GetDroppedFrameCount() const { return droppedFrames_.load(std::memory_order_relaxed); }
+	inline uint64_t GetFailedFrameCount() const { return failedFrames_.load(std::memory_order_relaxed); }
+	// How many times the pipeline had to wait because the queue was full
+	inline uint64_t GetStallCount() const { return stalls_.load(std::memory_order_relaxed); }
+
 protected:
 	struct PngBufferData
 	{
@@ -35,4 +48,27 @@ protected:
 	std::string directory_;
 
 	uint64_t frameIndex_;
+
+	bool dropWhenFull_;
+
+	// Image buffers are allocated as needed, at most queueCapacity of them, and recycled.
+	// buffers_ owns all of them and is only accessed on the pipeline thread and in the destructor
+	std::vector<uint8_t*> buffers_;
+	std::vector<uint8_t*> freeBuffers_;
+	std::queue<PngBufferData> queue_;
+	std::mutex queueMutex_;
+
+	std::counting_semaphore<> freeSlots_;
+	std::counting_semaphore<> queuedImages_;
+
+	std::vector<std::thread> workers_;
+
+	std::atomic<uint64_t> writtenFrames_;
+	std::atomic<uint64_t> droppedFrames_;
+	std::atomic<uint64_t> failedFrames_;
+	std::atomic<uint64_t> stalls_;
+
+	void WriteImagesAsync();
+
+	std::string GetFileName(const uint64_t& frameIndex) const;
 };
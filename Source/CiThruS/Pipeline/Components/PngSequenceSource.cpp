@@ -0,0 +1,78 @@
+#include "PngSequenceSource.h"
+
+#include <filesystem>
+#include <algorithm>
+#include <stdexcept>
+
+PngSequenceSource::PngSequenceSource(const std::string& directory, const uint16_t& imageWidth, const uint16_t& imageHeight,
+	const float& frameRate, const bool& loop, const uint8_t& prefetchCount)
+	: ReplaySourceBase(frameRate, loop, prefetchCount), imageWidth_(imageWidth), imageHeight_(imageHeight)
+{
+#ifdef CITHRUS_FPNG_AVAILABLE
+	fpng::fpng_init();
+#else
+	// Every frame would silently fail to decode otherwise
+	throw std::runtime_error("PNG decoding is not available, CiThruS was built without fpng");
+#endif // CITHRUS_FPNG_AVAILABLE
+
+	if (!std::filesystem::is_directory(directory))
+	{
+		throw std::invalid_argument("Given path is not a directory");
+	}
+
+	// PngRecorder names the files after their frame numbers
+	std::vector<std::pair<uint64_t, std::string>> frames;
+
+	for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory))
+	{
+		const std::filesystem::path& path = entry.path();
+		const std::string stem = path.stem().string();
+
+		if (!entry.is_regular_file() || path.extension() != ".png" || stem.empty()
+			|| !std::all_of(stem.begin(), stem.end(), [](const char& c) { return c >= '0' && c <= '9'; }))
+		{
+			continue;
+		}
+
+		frames.push_back({ std::stoull(stem), path.string() });
+	}
+
+	std::sort(frames.begin(), frames.end());
+
+	for (const std::pair<uint64_t, std::string>& frame : frames)
+	{
+		filePaths_.push_back(frame.second);
+	}
+
+	GetOutputPin<0>().Initialize(this, "rgba");
+
+	StartPrefetching();
+}
+
+PngSequenceSource::~PngSequenceSource()
+{
+	StopPrefetching();
+}
+
+uint64_t PngSequenceSource::GetFrameCount() const
+{
+	return filePaths_.size();
+}
+
+bool PngSequenceSource::ReadFrame(const uint64_t& index, std::vector<uint8_t>& frame)
+{
+#ifdef CITHRUS_FPNG_AVAILABLE
+	uint32_t width;
+	uint32_t height;
+	uint32_t channels;
+
+	if (fpng::fpng_decode_file(filePaths_[index].c_str(), frame, width, height, channels, 4) != fpng::FPNG_DECODE_SUCCESS)
+	{
+		return false;
+	}
+
+	return width == imageWidth_ && height == imageHeight_;
+#else
+	return false;
+#endif // CITHRUS_FPNG_AVAILABLE
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Optional/Fpng.h"
+#include "Pipeline/Internal/ReplaySourceBase.h"
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <vector>
+
+// Plays back RGBA images recorded by PngRecorder in the order of their frame numbers. Gaps in the
+// numbering are skipped. Only images written by fpng can be read
+class CITHRUS_API PngSequenceSource : public ReplaySourceBase
+{
+public:
+	// Images that don't match the given resolution are skipped. frameRate 0 outputs frames as fast as they are processed
+	PngSequenceSource(const std::string& directory, const uint16_t& imageWidth, const uint16_t& imageHeight,
+		const float& frameRate = 0.0f, const bool& loop = false, const uint8_t& prefetchCount = 4);
+	virtual ~PngSequenceSource();
+
+protected:
+	uint16_t imageWidth_;
+	uint16_t imageHeight_;
+
+	std::vector<std::string> filePaths_;
+
+	virtual uint64_t GetFrameCount() const override;
+	virtual bool ReadFrame(const uint64_t& index, std::vector<uint8_t>& frame) override;
+};
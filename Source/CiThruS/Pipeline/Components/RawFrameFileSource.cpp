@@ -0,0 +1,158 @@
+#include "RawFrameFileSource.h"
+
+#include <stdexcept>
+#include <algorithm>
+
+namespace
+{
+	const RawFrameContainer::FileHeader& GetFileHeader(const MappedFile& file)
+	{
+		if (file.GetSize() < sizeof(RawFrameContainer::FileHeader))
+		{
+			throw std::runtime_error("File is too small to be a raw frame recording");
+		}
+
+		const RawFrameContainer::FileHeader& header = *reinterpret_cast<const RawFrameContainer::FileHeader*>(file.GetData());
+
+		if (header.magic != RawFrameContainer::FILE_MAGIC)
+		{
+			throw std::runtime_error("File is not a raw frame recording");
+		}
+
+		if (header.version != RawFrameContainer::VERSION)
+		{
+			throw std::runtime_error("Unsupported raw frame recording version " + std::to_string(header.version));
+		}
+
+		return header;
+	}
+
+	std::string GetFormatName(const RawFrameContainer::FileHeader& header)
+	{
+		return std::string(header.format, strnlen(header.format, RawFrameContainer::FORMAT_LENGTH));
+	}
+}
+
+RawFrameFileSource::RawFrameFileSource(const std::string& filePath, const float& frameRate, const bool& loop, const uint8_t& prefetchCount)
+	: ReplaySourceBase(frameRate, loop, prefetchCount), file_(filePath)
+{
+	const RawFrameContainer::FileHeader& header = GetFileHeader(file_);
+
+	compression_ = static_cast<RawFrameContainer::Compression>(header.compression);
+	frameWidth_ = header.width;
+	frameHeight_ = header.height;
+
+	ReadIndex();
+
+	GetOutputPin<0>().Initialize(this, GetFormatName(header));
+
+	StartPrefetching();
+}
+
+RawFrameFileSource::~RawFrameFileSource()
+{
+	StopPrefetching();
+}
+
+std::string RawFrameFileSource::GetFormat(const std::string& filePath)
+{
+	MappedFile file(filePath);
+
+	return GetFormatName(GetFileHeader(file));
+}
+
+void RawFrameFileSource::ReadIndex()
+{
+	const uint8_t* data = file_.GetData();
+	const uint64_t size = file_.GetSize();
+
+	// Use the index at the end of the file if the recording was finished properly
+	if (size >= sizeof(RawFrameContainer::FileHeader) + sizeof(RawFrameContainer::IndexTrailer))
+	{
+		const RawFrameContainer::IndexTrailer& trailer = *reinterpret_cast<const RawFrameContainer::IndexTrailer*>(data + size - sizeof(RawFrameContainer::IndexTrailer));
+
+		// Compared without multiplying so that a corrupted frame count can't overflow past the check
+		if (trailer.magic == RawFrameContainer::INDEX_MAGIC
+			&& trailer.indexOffset >= sizeof(RawFrameContainer::FileHeader)
+			&& trailer.indexOffset <= size - sizeof(RawFrameContainer::IndexTrailer)
+			&& (size - sizeof(RawFrameContainer::IndexTrailer) - trailer.indexOffset) % sizeof(RawFrameContainer::IndexEntry) == 0
+			&& (size - sizeof(RawFrameContainer::IndexTrailer) - trailer.indexOffset) / sizeof(RawFrameContainer::IndexEntry) == trailer.frameCount)
+		{
+			const RawFrameContainer::IndexEntry* entries = reinterpret_cast<const RawFrameContainer::IndexEntry*>(data + trailer.indexOffset);
+
+			// Every frame has to lie between the file header and the index
+			const bool indexValid = std::all_of(entries, entries + trailer.frameCount, [&](const RawFrameContainer::IndexEntry& entry)
+				{
+					return entry.offset >= sizeof(RawFrameContainer::FileHeader)
+						&& entry.offset <= trailer.indexOffset
+						&& trailer.indexOffset - entry.offset >= sizeof(RawFrameContainer::FrameHeader)
+						&& entry.compressedSize <= trailer.indexOffset - entry.offset - sizeof(RawFrameContainer::FrameHeader);
+				});
+
+			if (indexValid)
+			{
+				index_.assign(entries, entries + trailer.frameCount);
+
+				return;
+			}
+		}
+	}
+
+	// Otherwise recover as many frames as possible by walking through the frame headers
+	uint64_t offset = sizeof(RawFrameContainer::FileHeader);
+
+	while (offset + sizeof(RawFrameContainer::FrameHeader) <= size)
+	{
+		const RawFrameContainer::FrameHeader& frameHeader = *reinterpret_cast<const RawFrameContainer::FrameHeader*>(data + offset);
+
+		if (frameHeader.magic != RawFrameContainer::FRAME_MAGIC || offset + sizeof(frameHeader) + frameHeader.compressedSize > size)
+		{
+			break;
+		}
+
+		index_.push_back({ offset, frameHeader.compressedSize, frameHeader.uncompressedSize, frameHeader.frameNumber, frameHeader.timestamp });
+
+		offset += sizeof(frameHeader) + frameHeader.compressedSize;
+	}
+}
+
+uint64_t RawFrameFileSource::GetFrameCount() const
+{
+	return index_.size();
+}
+
+bool RawFrameFileSource::ReadFrame(const uint64_t& index, std::vector<uint8_t>& frame)
+{
+	const RawFrameContainer::IndexEntry& entry = index_[index];
+	const uint8_t* compressed = file_.GetData() + entry.offset + sizeof(RawFrameContainer::FrameHeader);
+
+	frame.resize(entry.uncompressedSize);
+
+	switch (compression_)
+	{
+	case RawFrameContainer::CompressionNone:
+		if (entry.compressedSize != entry.uncompressedSize)
+		{
+			return false;
+		}
+
+		memcpy(frame.data(), compressed, entry.uncompressedSize);
+
+		return true;
+
+#ifdef CITHRUS_LZ4_AVAILABLE
+	case RawFrameContainer::CompressionLz4:
+		return LZ4_decompress_safe(
+			reinterpret_cast<const char*>(compressed), reinterpret_cast<char*>(frame.data()),
+			entry.compressedSize, entry.uncompressedSize) == static_cast<int>(entry.uncompressedSize);
+#endif // CITHRUS_LZ4_AVAILABLE
+
+#ifdef CITHRUS_ZSTD_AVAILABLE
+	case RawFrameContainer::CompressionZstd:
+		return ZSTD_decompress(frame.data(), frame.size(), compressed, entry.compressedSize) == entry.uncompressedSize;
+#endif // CITHRUS_ZSTD_AVAILABLE
+
+	default:
+		throw std::runtime_error("The compression used in the recording is unavailable");
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Optional/Lz4.h"
+#include "Optional/Zstd.h"
+#include "Pipeline/Internal/ReplaySourceBase.h"
+#include "Pipeline/Internal/MappedFile.h"
+#include "Pipeline/Internal/RawFrameContainer.h"
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <vector>
+
+// Plays back frames recorded by RawFrameRecorder. The output format is the format the frames were recorded in
+class CITHRUS_API RawFrameFileSource : public ReplaySourceBase
+{
+public:
+	// frameRate 0 outputs frames as fast as they are processed
+	RawFrameFileSource(const std::string& filePath, const float& frameRate = 0.0f, const bool& loop = false, const uint8_t& prefetchCount = 4);
+	virtual ~RawFrameFileSource();
+
+	// Returns the data format of the frames in a recording without opening it as a source
+	static std::string GetFormat(const std::string& filePath);
+
+	// Size of the recorded frames in pixels, 0 if the recorder didn't know it
+	inline uint16_t GetFrameWidth() const { return frameWidth_; }
+	inline uint16_t GetFrameHeight() const { return frameHeight_; }
+
+protected:
+	MappedFile file_;
+
+	uint16_t frameWidth_;
+	uint16_t frameHeight_;
+
+	RawFrameContainer::Compression compression_;
+	std::vector<RawFrameContainer::IndexEntry> index_;
+
+	virtual uint64_t GetFrameCount() const override;
+	virtual bool ReadFrame(const uint64_t& index, std::vector<uint8_t>& frame) override;
+
+	void ReadIndex();
+};
@@ -0,0 +1,341 @@
+#include "RawFrameRecorder.h"
+#include "Misc/Debug.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <chrono>
+#include <algorithm>
+
+RawFrameRecorder::RawFrameRecorder(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight,
+	const RawFrameContainer::Compression& compression, const int& compressionLevel,
+	const uint8_t& workerCount, const uint16_t& queueCapacity, const bool& dropWhenFull)
+	: fileHandle_(nullptr), fileOffset_(0), writeFailed_(false), frameWidth_(frameWidth), frameHeight_(frameHeight), compression_(compression), compressionLevel_(compressionLevel), frameNumber_(0), writeOrder_(0),
+	dropWhenFull_(dropWhenFull), freeSlots_(queueCapacity), queuedFrames_(0), nextWriteOrder_(0),
+	writtenFrames_(0), droppedFrames_(0), failedFrames_(0), stalls_(0), uncompressedBytes_(0), compressedBytes_(0)
+{
+	if (workerCount == 0)
+	{
+		throw std::invalid_argument("RawFrameRecorder needs at least one worker thread");
+	}
+
+	if (queueCapacity == 0)
+	{
+		throw std::invalid_argument("RawFrameRecorder queue capacity cannot be 0");
+	}
+
+#ifndef CITHRUS_LZ4_AVAILABLE
+	if (compression_ == RawFrameContainer::CompressionLz4)
+	{
+		Debug::Log("LZ4 is unavailable, recording uncompressed frames instead");
+		compression_ = RawFrameContainer::CompressionNone;
+	}
+#endif // CITHRUS_LZ4_AVAILABLE
+
+#ifndef CITHRUS_ZSTD_AVAILABLE
+	if (compression_ == RawFrameContainer::CompressionZstd)
+	{
+		Debug::Log("zstd is unavailable, recording uncompressed frames instead");
+		compression_ = RawFrameContainer::CompressionNone;
+	}
+#endif // CITHRUS_ZSTD_AVAILABLE
+
+	GetInputPin<0>().Initialize(this);
+
+	if (std::filesystem::exists(filePath))
+	{
+		if (!std::filesystem::is_regular_file(filePath))
+		{
+			throw std::invalid_argument("Given path is not a file");
+		}
+	}
+	else
+	{
+		std::filesystem::path directoryPath = std::filesystem::path(filePath).parent_path();
+
+		if (!directoryPath.empty() && !std::filesystem::exists(directoryPath))
+		{
+			std::filesystem::create_directories(directoryPath);
+		}
+	}
+
+	fileHandle_ = fopen(filePath.data(), "wb");
+
+	if (fileHandle_ == nullptr)
+	{
+		throw std::logic_error("Failed to open file");
+	}
+
+	for (int i = 0; i < queueCapacity; i++)
+	{
+		buffers_.push_back(new FrameBuffer());
+	}
+
+	freeBuffers_ = buffers_;
+
+	for (int i = 0; i < workerCount; i++)
+	{
+		workers_.push_back(std::thread(&RawFrameRecorder::CompressFramesAsync, this));
+	}
+}
+
+RawFrameRecorder::~RawFrameRecorder()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+
+		// Each worker stops when it gets an empty entry, which only happens after the actual frames have been written
+		for (size_t i = 0; i < workers_.size(); i++)
+		{
+			queue_.push(nullptr);
+		}
+	}
+
+	queuedFrames_.release(workers_.size());
+
+	for (std::thread& worker : workers_)
+	{
+		worker.join();
+	}
+
+	for (FrameBuffer* buffer : buffers_)
+	{
+		delete buffer;
+	}
+
+	buffers_.clear();
+	freeBuffers_.clear();
+
+	RawFrameContainer::IndexTrailer trailer;
+
+	trailer.indexOffset = fileOffset_;
+	trailer.frameCount = index_.size();
+	trailer.magic = RawFrameContainer::INDEX_MAGIC;
+
+	// An index after a failed write wouldn't match the file, so readers fall back to walking the frame headers
+	if (!writeFailed_)
+	{
+		fwrite(index_.data(), sizeof(RawFrameContainer::IndexEntry), index_.size(), fileHandle_);
+		fwrite(&trailer, sizeof(trailer), 1, fileHandle_);
+	}
+
+	fclose(fileHandle_);
+
+	fileHandle_ = nullptr;
+}
+
+void RawFrameRecorder::OnInputPinsConnected()
+{
+	std::string format = GetInputPin<0>().GetFormat();
+
+	if (format.size() >= RawFrameContainer::FORMAT_LENGTH)
+	{
+		throw std::invalid_argument("Format name " + format + " is too long to be recorded");
+	}
+
+	RawFrameContainer::FileHeader header = {};
+
+	header.magic = RawFrameContainer::FILE_MAGIC;
+	header.version = RawFrameContainer::VERSION;
+	header.compression = compression_;
+	memcpy(header.format, format.data(), format.size());
+	header.width = frameWidth_;
+	header.height = frameHeight_;
+
+	if (fwrite(&header, sizeof(header), 1, fileHandle_) != 1)
+	{
+		throw std::runtime_error("Failed to write raw frame recording header");
+	}
+
+	fileOffset_ = sizeof(header);
+}
+
+void RawFrameRecorder::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	if (!inputData || inputSize == 0)
+	{
+		return;
+	}
+
+	const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	const uint64_t frameNumber = frameNumber_;
+
+	frameNumber_++;
+
+	if (!freeSlots_.try_acquire())
+	{
+		if (dropWhenFull_)
+		{
+			droppedFrames_.fetch_add(1, std::memory_order_relaxed);
+
+			return;
+		}
+
+		stalls_.fetch_add(1, std::memory_order_relaxed);
+		freeSlots_.acquire();
+	}
+
+	FrameBuffer* frame;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+
+		frame = freeBuffers_.back();
+		freeBuffers_.pop_back();
+	}
+
+	// Only grows, so this allocates during the first few frames at most
+	if (frame->data.size() < inputSize)
+	{
+		frame->data.resize(inputSize);
+	}
+
+	memcpy(frame->data.data(), inputData, inputSize);
+
+	frame->size = inputSize;
+	frame->frameNumber = frameNumber;
+	frame->timestamp = timestamp;
+	frame->writeOrder = writeOrder_;
+
+	writeOrder_++;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex_);
+
+		queue_.push(frame);
+	}
+
+	queuedFrames_.release();
+}
+
+void RawFrameRecorder::CompressFramesAsync()
+{
+	std::vector<uint8_t> compressed;
+	void* context = nullptr;
+
+#ifdef CITHRUS_ZSTD_AVAILABLE
+	if (compression_ == RawFrameContainer::CompressionZstd)
+	{
+		context = ZSTD_createCCtx();
+	}
+#endif // CITHRUS_ZSTD_AVAILABLE
+
+	while (true)
+	{
+		queuedFrames_.acquire();
+
+		FrameBuffer* frame;
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex_);
+
+			frame = queue_.front();
+			queue_.pop();
+		}
+
+		if (!frame)
+		{
+			break;
+		}
+
+		const uint32_t compressedSize = Compress(*frame, compressed, context);
+		const uint8_t* payload = compression_ == RawFrameContainer::CompressionNone ? frame->data.data() : compressed.data();
+
+		RawFrameContainer::FrameHeader header;
+
+		header.magic = RawFrameContainer::FRAME_MAGIC;
+		header.compressedSize = compressedSize;
+		header.uncompressedSize = frame->size;
+		header.frameNumber = frame->frameNumber;
+		header.timestamp = frame->timestamp;
+
+		bool written = false;
+
+		{
+			std::unique_lock<std::mutex> lock(writeMutex_);
+
+			writeCv_.wait(lock, [this, frame] { return nextWriteOrder_ == frame->writeOrder; });
+
+			// Failed frames still have to give up their turn or the rest of the workers would wait forever
+			if (compressedSize != 0 && !writeFailed_)
+			{
+				if (fwrite(&header, sizeof(header), 1, fileHandle_) == 1 && fwrite(payload, 1, compressedSize, fileHandle_) == compressedSize)
+				{
+					index_.push_back({ fileOffset_, header.compressedSize, header.uncompressedSize, header.frameNumber, header.timestamp });
+
+					fileOffset_ += sizeof(header) + compressedSize;
+					written = true;
+				}
+				else
+				{
+					writeFailed_ = true;
+
+					Debug::Log("Writing into raw frame recording failed, the rest of the frames are discarded");
+				}
+			}
+
+			nextWriteOrder_++;
+		}
+
+		writeCv_.notify_all();
+
+		if (written)
+		{
+			writtenFrames_.fetch_add(1, std::memory_order_relaxed);
+			uncompressedBytes_.fetch_add(frame->size, std::memory_order_relaxed);
+			compressedBytes_.fetch_add(compressedSize, std::memory_order_relaxed);
+		}
+		else
+		{
+			failedFrames_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(queueMutex_);
+
+			freeBuffers_.push_back(frame);
+		}
+
+		freeSlots_.release();
+	}
+
+#ifdef CITHRUS_ZSTD_AVAILABLE
+	if (context)
+	{
+		ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(context));
+	}
+#endif // CITHRUS_ZSTD_AVAILABLE
+}
+
+uint32_t RawFrameRecorder::Compress(const FrameBuffer& frame, std::vector<uint8_t>& compressed, void* context)
+{
+	switch (compression_)
+	{
+#ifdef CITHRUS_LZ4_AVAILABLE
+	case RawFrameContainer::CompressionLz4:
+	{
+		compressed.resize(LZ4_compressBound(frame.size));
+
+		return LZ4_compress_fast(
+			reinterpret_cast<const char*>(frame.data.data()), reinterpret_cast<char*>(compressed.data()),
+			frame.size, static_cast<int>(compressed.size()), std::max(compressionLevel_, 1));
+	}
+#endif // CITHRUS_LZ4_AVAILABLE
+
+#ifdef CITHRUS_ZSTD_AVAILABLE
+	case RawFrameContainer::CompressionZstd:
+	{
+		compressed.resize(ZSTD_compressBound(frame.size));
+
+		size_t result = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(context), compressed.data(), compressed.size(), frame.data.data(), frame.size, compressionLevel_);
+
+		return ZSTD_isError(result) ? 0 : static_cast<uint32_t>(result);
+	}
+#endif // CITHRUS_ZSTD_AVAILABLE
+
+	default:
+		return frame.size;
+	}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Optional/Lz4.h"
+#include "Optional/Zstd.h"
+#include "Pipeline/Internal/PipelineSink.h"
+#include "Pipeline/Internal/RawFrameContainer.h"
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <vector>
+#include <atomic>
+#include <semaphore>
+#include <stdio.h>
+
+// Records frames of any format losslessly into a single container file, see RawFrameContainer.h for
+// the layout. Each frame is compressed separately with LZ4 or zstd on a pool of worker threads and
+// the frames are written in the order they were received. Much cheaper than PNG or lossless HEVC,
+// at the cost of larger files
+class CITHRUS_API RawFrameRecorder : public PipelineSink<1>
+{
+public:
+	// compressionLevel is the acceleration factor for LZ4 (higher is faster) and the compression level for zstd.
+	// queueCapacity is the maximum number of frames waiting to be compressed. When the queue is full, the
+	// pipeline waits for a worker to catch up unless dropWhenFull is set, in which case the frame is skipped.
+	// Falls back to storing frames uncompressed if the requested compression library is unavailable. The frame size is
+	// stored in the file so that it can be interpreted without knowing how it was recorded
+	RawFrameRecorder(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight,
+		const RawFrameContainer::Compression& compression = RawFrameContainer::CompressionLz4, const int& compressionLevel = 1,
+		const uint8_t& workerCount = 4, const uint16_t& queueCapacity = 16, const bool& dropWhenFull = false);
+	// Waits for all queued frames to be written and finishes the file with the frame index
+	virtual ~RawFrameRecorder();
+
+	virtual void Process() override;
+
+	virtual void OnInputPinsConnected() override;
+
+	inline uint64_t GetWrittenFrameCount() const { return writtenFrames_.load(std::memory_order_relaxed); }
+	inline uint64_t GetDroppedFrameCount() const { return droppedFrames_.load(std::memory_order_relaxed); }
+	// Frames that couldn't be compressed or written into the file
+	inline uint64_t GetFailedFrameCount() const { return failedFrames_.load(std::memory_order_relaxed); }
+	inline uint64_t GetStallCount() const { return stalls_.load(std::memory_order_relaxed); }
+	inline uint64_t GetUncompressedByteCount() const { return uncompressedBytes_.load(std::memory_order_relaxed); }
+	inline uint64_t GetCompressedByteCount() const { return compressedBytes_.load(std::memory_order_relaxed); }
+
+protected:
+	struct FrameBuffer
+	{
+		std::vector<uint8_t> data;
+		uint32_t size;
+		uint64_t frameNumber;
+		int64_t timestamp;
+
+		// Order in which the frame must be written
+		uint64_t writeOrder;
+	};
+
+	FILE* fileHandle_;
+	uint64_t fileOffset_;
+
+	// Set when writing into the file failed. The file can't be trusted after that, so nothing more is written
+	// into it and the frames that made it can be recovered by walking the frame headers
+	bool writeFailed_;
+
+	uint16_t frameWidth_;
+	uint16_t frameHeight_;
+
+	RawFrameContainer::Compression compression_;
+	int compressionLevel_;
+
+	uint64_t frameNumber_;
+	uint64_t writeOrder_;
+
+	bool dropWhenFull_;
+
+	// All frame buffers are allocated up front and recycled
+	std::vector<FrameBuffer*> buffers_;
+	std::vector<FrameBuffer*> freeBuffers_;
+	std::queue<FrameBuffer*> queue_;
+	std::mutex queueMutex_;
+
+	std::counting_semaphore<> freeSlots_;
+	std::counting_semaphore<> queuedFrames_;
+
+	// Workers take turns writing their frames into the file
+	std::mutex writeMutex_;
+	std::condition_variable writeCv_;
+	uint64_t nextWriteOrder_;
+
+	std::vector<RawFrameContainer::IndexEntry> index_;
+
+	std::vector<std::thread> workers_;
+
+	std::atomic<uint64_t> writtenFrames_;
+	std::atomic<uint64_t> droppedFrames_;
+	std::atomic<uint64_t> failedFrames_;
+	std::atomic<uint64_t> stalls_;
+	std::atomic<uint64_t> uncompressedBytes_;
+	std::atomic<uint64_t> compressedBytes_;
+
+	void CompressFramesAsync();
+
+	// Returns the size of the compressed data, or 0 if compression failed
+	uint32_t Compress(const FrameBuffer& frame, std::vector<uint8_t>& compressed, void* context);
+};
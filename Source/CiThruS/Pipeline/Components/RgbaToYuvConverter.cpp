@@ -58,10 +58,28 @@ void RgbaToYuvConverter::Process()
         return;
     }
 
-	(this->*converterFunction_)(inputData, &outputData_, outputFrameWidth_, outputFrameHeight_);
+    const uint32_t lumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+    uint8_t* yOutput = outputData_;
+    uint8_t* uOutput = outputData_ + lumaSize;
+    uint8_t* vOutput = outputData_ + lumaSize * 5 / 4;
+
+    // Write directly into memory lent by the next component if possible so that it doesn't have to copy the image
+    if (GetOutputPin<0>().HasLentPlanes({ lumaSize, lumaSize / 4, lumaSize / 4 }))
+    {
+        const std::vector<OutputPin::LentPlane>& lentPlanes = GetOutputPin<0>().GetLentPlanes();
+
+        yOutput = lentPlanes[0].data;
+        uOutput = lentPlanes[1].data;
+        vOutput = lentPlanes[2].data;
+    }
+
+    (this->*converterFunction_)(inputData, yOutput, uOutput, vOutput, outputFrameWidth_, outputFrameHeight_);
+
+    GetOutputPin<0>().SetData(yOutput);
 }
 
-void RgbaToYuvConverter::RgbaToYuvDefault(const uint8_t* input, uint8_t** output, int width, int height)
+void RgbaToYuvConverter::RgbaToYuvDefault(const uint8_t* input, uint8_t* yOutput, uint8_t* uOutput, uint8_t* vOutput, int width, int height)
 {
     if (!initialized_)
     {
@@ -103,10 +121,10 @@ void RgbaToYuvConverter::RgbaToYuvDefault(const uint8_t* input, uint8_t** output
             int32_t yBottomRight = R_Y * rgbaBottomRight[rOffset_] + G_Y * rgbaBottomRight[gOffset_] + B_Y * rgbaBottomRight[bOffset_];
 
             // Fixed point multiplication
-            (*output)[(i * 2 + 0) * width + (j * 2 + 0)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yTopLeft     >> 8));
-            (*output)[(i * 2 + 0) * width + (j * 2 + 1)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yTopRight    >> 8));
-            (*output)[(i * 2 + 1) * width + (j * 2 + 0)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yBottomLeft  >> 8));
-            (*output)[(i * 2 + 1) * width + (j * 2 + 1)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yBottomRight >> 8));
+            yOutput[(i * 2 + 0) * width + (j * 2 + 0)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yTopLeft     >> 8));
+            yOutput[(i * 2 + 0) * width + (j * 2 + 1)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yTopRight    >> 8));
+            yOutput[(i * 2 + 1) * width + (j * 2 + 0)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yBottomLeft  >> 8));
+            yOutput[(i * 2 + 1) * width + (j * 2 + 1)] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, yBottomRight >> 8));
 
             // Average U and V from 4 pixels in a square
             int16_t rSum = rgbaTopLeft[rOffset_] + rgbaTopRight[rOffset_] + rgbaBottomLeft[rOffset_] + rgbaBottomRight[rOffset_];
@@ -114,14 +132,14 @@ void RgbaToYuvConverter::RgbaToYuvDefault(const uint8_t* input, uint8_t** output
             int16_t bSum = rgbaTopLeft[bOffset_] + rgbaTopRight[bOffset_] + rgbaBottomLeft[bOffset_] + rgbaBottomRight[bOffset_];
 
             // Fixed point multiplication
-            (*output)[i * width / 2 + j + width * height]         = std::max(CHROMA_MIN, std::min(CHROMA_MAX, (R_U * rSum + G_U * gSum + B_U * bSum + (CHROMA_MID << 10)) >> 10));
-            (*output)[i * width / 2 + j + width * height * 5 / 4] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, (R_V * rSum + G_V * gSum + B_V * bSum + (CHROMA_MID << 10)) >> 10));
+            uOutput[i * width / 2 + j] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, (R_U * rSum + G_U * gSum + B_U * bSum + (CHROMA_MID << 10)) >> 10));
+            vOutput[i * width / 2 + j] = std::max(CHROMA_MIN, std::min(CHROMA_MAX, (R_V * rSum + G_V * gSum + B_V * bSum + (CHROMA_MID << 10)) >> 10));
         }
     }
 }
 
 #ifdef CITHRUS_SSE41_AVAILABLE
-void RgbaToYuvConverter::RgbaToYuvSse41(const uint8_t* input, uint8_t** output, int width, int height)
+void RgbaToYuvConverter::RgbaToYuvSse41(const uint8_t* input, uint8_t* yOutput, uint8_t* uOutput, uint8_t* vOutput, int width, int height)
 {
     // This efficiently converts pixels from RGBA to YUV 4:2:0 by using SSE 4.1 instructions to process multiple values simultaneously
 
@@ -151,9 +169,9 @@ void RgbaToYuvConverter::RgbaToYuvSse41(const uint8_t* input, uint8_t** output,
         }
     }
 
-    uint8_t* yOut = *output;
-    uint8_t* uOut = *output + width * height;
-    uint8_t* vOut = *output + width * height * 5 / 4;
+    uint8_t* yOut = yOutput;
+    uint8_t* uOut = uOutput;
+    uint8_t* vOut = vOutput;
 
     // Calculate Y 4 pixels at a time, 4x1 rectangle
     for (int i = 0; i < width * height / 4; i++)
@@ -19,7 +19,7 @@ protected:
 	uint16_t outputFrameWidth_;
 	uint16_t outputFrameHeight_;
 
-    void (RgbaToYuvConverter::*converterFunction_)(const uint8_t* input, uint8_t** output, int width, int height);
+    void (RgbaToYuvConverter::*converterFunction_)(const uint8_t* input, uint8_t* yOutput, uint8_t* uOutput, uint8_t* vOutput, int width, int height);
 
     // Fixed point coefficients from ITU-R BT.601
     const static int16_t R_Y =   76;
@@ -44,7 +44,7 @@ protected:
 
     bool initialized_;
 
-    void RgbaToYuvDefault(const uint8_t* input, uint8_t** output, int width, int height);
+    void RgbaToYuvDefault(const uint8_t* input, uint8_t* yOutput, uint8_t* uOutput, uint8_t* vOutput, int width, int height);
 
 #ifdef CITHRUS_SSE41_AVAILABLE
     const __m128i rY_ = _mm_set_epi32(R_Y, R_Y, R_Y, R_Y);
@@ -70,6 +70,6 @@ protected:
     __m128i gShuffleMask_;
     __m128i bShuffleMask_;
 
-    void RgbaToYuvSse41(const uint8_t* input, uint8_t** output, int width, int height);
+    void RgbaToYuvSse41(const uint8_t* input, uint8_t* yOutput, uint8_t* uOutput, uint8_t* vOutput, int width, int height);
 #endif // CITHRUS_SSE41_AVAILABLE
 };
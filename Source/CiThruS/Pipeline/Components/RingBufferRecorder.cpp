@@ -0,0 +1,393 @@
+#include "RingBufferRecorder.h"
+#include "Misc/Debug.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+
+namespace
+{
+	const uint8_t HEVC_START_CODE[] = { 0, 0, 1 };
+
+	const uint8_t HEVC_NAL_VPS = 32;
+	const uint8_t HEVC_NAL_PPS = 34;
+
+	// Calls onNal with the type, start and size of each NAL unit in an Annex B stream. The start and size
+	// don't include the start code
+	template <typename TCallback>
+	void ForEachHevcNal(const uint8_t* data, const uint32_t& size, TCallback onNal)
+	{
+		uint32_t nalStart = 0;
+		bool inNal = false;
+
+		for (uint32_t i = 0; i + 3 < size; i++)
+		{
+			if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1)
+			{
+				continue;
+			}
+
+			if (inNal)
+			{
+				// The extra zero of a four byte start code belongs to the next start code
+				const uint32_t nalEnd = i > nalStart && data[i - 1] == 0 ? i - 1 : i;
+
+				onNal((data[nalStart] >> 1) & 0x3F, data + nalStart, nalEnd - nalStart);
+			}
+
+			nalStart = i + 3;
+			inNal = true;
+
+			i += 2;
+		}
+
+		if (inNal)
+		{
+			onNal((data[nalStart] >> 1) & 0x3F, data + nalStart, size - nalStart);
+		}
+	}
+}
+
+RingBufferRecorder::RingBufferRecorder(const std::string& directory, const float& bufferDuration, const uint64_t& bufferSize,
+	std::function<void(const std::string&)> onSaved, const uint16_t& frameWidth, const uint16_t& frameHeight)
+	: directory_(directory), onSaved_(onSaved), hevc_(false), frameWidth_(frameWidth), frameHeight_(frameHeight), writeOffset_(0), frameNumber_(0), triggered_(false), saving_(false),
+	saveRequested_(false), stopSaving_(false), saveCount_(0), savedRecordings_(0), droppedFrames_(0)
+{
+	if (bufferDuration <= 0.0f)
+	{
+		throw std::invalid_argument("Buffer duration must be positive");
+	}
+
+	if (bufferSize == 0)
+	{
+		throw std::invalid_argument("Buffer size cannot be 0");
+	}
+
+	if (std::filesystem::exists(directory_))
+	{
+		if (!std::filesystem::is_directory(directory_))
+		{
+			throw std::invalid_argument("Given path is not a directory");
+		}
+	}
+	else
+	{
+		std::filesystem::create_directories(directory_);
+	}
+
+	bufferDuration_ = static_cast<int64_t>(bufferDuration * 1e9);
+
+	// Both buffers are allocated up front so that recording never allocates memory
+	ring_.resize(bufferSize);
+	saveBuffer_.resize(bufferSize);
+
+	GetInputPin<0>().Initialize(this);
+
+	saveThread_ = std::thread(&RingBufferRecorder::SaveRecordingsAsync, this);
+}
+
+RingBufferRecorder::~RingBufferRecorder()
+{
+	// Save whatever is in the buffer if no more frames arrived after the trigger
+	if (triggered_.exchange(false))
+	{
+		TakeSnapshot();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(saveMutex_);
+
+		stopSaving_ = true;
+	}
+
+	saveCv_.notify_one();
+	saveThread_.join();
+}
+
+void RingBufferRecorder::OnInputPinsConnected()
+{
+	format_ = GetInputPin<0>().GetFormat();
+	hevc_ = format_ == "hevc";
+
+	if (!hevc_ && format_.size() >= RawFrameContainer::FORMAT_LENGTH)
+	{
+		throw std::invalid_argument("Format name " + format_ + " is too long to be recorded");
+	}
+}
+
+void RingBufferRecorder::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	const uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	if (inputData && inputSize != 0)
+	{
+		const int64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+		EvictExpiredFrames(timestamp);
+		StoreFrame(inputData, inputSize, timestamp);
+	}
+
+	if (triggered_.exchange(false))
+	{
+		TakeSnapshot();
+	}
+}
+
+bool RingBufferRecorder::Trigger()
+{
+	bool expected = false;
+
+	// The snapshot buffer can't be reused until the previous save has finished
+	if (!saving_.compare_exchange_strong(expected, true))
+	{
+		return false;
+	}
+
+	triggered_ = true;
+
+	return true;
+}
+
+void RingBufferRecorder::StoreFrame(const uint8_t* data, const uint32_t& size, const int64_t& timestamp)
+{
+	if (size > ring_.size())
+	{
+		droppedFrames_++;
+
+		return;
+	}
+
+	if (frames_.empty())
+	{
+		writeOffset_ = 0;
+	}
+
+	uint64_t offset = writeOffset_;
+
+	if (offset + size > ring_.size())
+	{
+		// The frames between the write offset and the end of the ring are the oldest ones, so they go first
+		while (!frames_.empty() && frames_.front().offset >= writeOffset_)
+		{
+			frames_.pop_front();
+		}
+
+		offset = 0;
+	}
+
+	// Evict the oldest frames until the new frame fits
+	while (!frames_.empty() && frames_.front().offset < offset + size && offset < frames_.front().offset + frames_.front().size)
+	{
+		frames_.pop_front();
+	}
+
+	memcpy(ring_.data() + offset, data, size);
+
+	frames_.push_back({ offset, size, frameNumber_++, timestamp, !hevc_ || InspectHevcFrame(data, size) });
+	writeOffset_ = offset + size;
+
+	EvictUndecodableFrames();
+}
+
+bool RingBufferRecorder::InspectHevcFrame(const uint8_t* data, const uint32_t& size)
+{
+	bool irap = false;
+
+	ForEachHevcNal(data, size, [&](const uint8_t& nalType, const uint8_t* nal, const uint32_t& nalSize)
+		{
+			// Any intra random access point can be decoded on its own given the parameter sets
+			irap |= nalType >= 16 && nalType <= 23;
+
+			if (nalType >= HEVC_NAL_VPS && nalType <= HEVC_NAL_PPS)
+			{
+				std::vector<uint8_t>& parameterSet = parameterSets_[nalType - HEVC_NAL_VPS];
+
+				parameterSet.assign(HEVC_START_CODE, HEVC_START_CODE + sizeof(HEVC_START_CODE));
+				parameterSet.insert(parameterSet.end(), nal, nal + nalSize);
+			}
+		});
+
+	return irap;
+}
+
+void RingBufferRecorder::EvictExpiredFrames(const int64_t& timestamp)
+{
+	const int64_t cutoff = timestamp - bufferDuration_;
+
+	while (!frames_.empty() && frames_.front().timestamp < cutoff)
+	{
+		if (!hevc_)
+		{
+			frames_.pop_front();
+
+			continue;
+		}
+
+		// HEVC frames depend on the keyframe before them, so they can only be evicted one keyframe interval
+		// at a time once the next interval alone covers the whole buffer duration
+		std::deque<Frame>::iterator nextKeyframe = std::find_if(frames_.begin() + 1, frames_.end(), [](const Frame& frame) { return frame.keyframe; });
+
+		if (nextKeyframe == frames_.end() || nextKeyframe->timestamp > cutoff)
+		{
+			break;
+		}
+
+		frames_.erase(frames_.begin(), nextKeyframe);
+	}
+}
+
+void RingBufferRecorder::EvictUndecodableFrames()
+{
+	// Frames whose keyframe has been evicted can't be decoded anymore
+	while (!frames_.empty() && !frames_.front().keyframe)
+	{
+		frames_.pop_front();
+	}
+}
+
+void RingBufferRecorder::TakeSnapshot()
+{
+	saveFrames_.clear();
+	saveParameterSets_.clear();
+
+	if (hevc_)
+	{
+		for (const std::vector<uint8_t>& parameterSet : parameterSets_)
+		{
+			saveParameterSets_.insert(saveParameterSets_.end(), parameterSet.begin(), parameterSet.end());
+		}
+	}
+
+	uint64_t offset = 0;
+
+	for (const Frame& frame : frames_)
+	{
+		memcpy(saveBuffer_.data() + offset, ring_.data() + frame.offset, frame.size);
+
+		saveFrames_.push_back({ offset, frame.size, frame.frameNumber, frame.timestamp, frame.keyframe });
+		offset += frame.size;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(saveMutex_);
+
+		saveRequested_ = true;
+	}
+
+	saveCv_.notify_one();
+}
+
+void RingBufferRecorder::SaveRecordingsAsync()
+{
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock(saveMutex_);
+
+		saveCv_.wait(lock, [this]() { return saveRequested_ || stopSaving_; });
+
+		if (!saveRequested_)
+		{
+			return;
+		}
+
+		saveRequested_ = false;
+
+		lock.unlock();
+
+		try
+		{
+			std::string filePath = SaveSnapshot();
+
+			if (!filePath.empty())
+			{
+				savedRecordings_++;
+
+				Debug::Log("Saved buffered recording to " + filePath);
+
+				if (onSaved_)
+				{
+					onSaved_(filePath);
+				}
+			}
+			else
+			{
+				Debug::Log("Nothing has been buffered yet, recording was not saved");
+			}
+		}
+		catch (const std::exception& exception)
+		{
+			Debug::Log("Saving buffered recording failed: " + std::string(exception.what()));
+		}
+
+		saving_ = false;
+	}
+}
+
+std::string RingBufferRecorder::SaveSnapshot()
+{
+	if (saveFrames_.empty())
+	{
+		return "";
+	}
+
+	const int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	const std::string fileName = std::to_string(seconds) + "_" + std::to_string(saveCount_++) + (hevc_ ? ".hevc" : ".ctraw");
+	const std::string filePath = (std::filesystem::path(directory_) / fileName).string();
+
+	FILE* fileHandle = fopen(filePath.data(), "wb");
+
+	if (fileHandle == nullptr)
+	{
+		throw std::runtime_error("Failed to open file " + filePath);
+	}
+
+	const uint64_t dataSize = saveFrames_.back().offset + saveFrames_.back().size;
+
+	// Annex B streams can simply be concatenated. Parameter sets repeated by the first keyframe just replace
+	// the prepended ones
+	if (hevc_)
+	{
+		fwrite(saveParameterSets_.data(), 1, saveParameterSets_.size(), fileHandle);
+		fwrite(saveBuffer_.data(), 1, dataSize, fileHandle);
+		fclose(fileHandle);
+
+		return filePath;
+	}
+
+	RawFrameContainer::FileHeader header = {};
+
+	header.magic = RawFrameContainer::FILE_MAGIC;
+	header.version = RawFrameContainer::VERSION;
+	header.compression = RawFrameContainer::CompressionNone;
+	memcpy(header.format, format_.data(), format_.size());
+	header.width = frameWidth_;
+	header.height = frameHeight_;
+
+	fwrite(&header, sizeof(header), 1, fileHandle);
+
+	uint64_t fileOffset = sizeof(header);
+	std::vector<RawFrameContainer::IndexEntry> index;
+
+	for (const Frame& frame : saveFrames_)
+	{
+		RawFrameContainer::FrameHeader frameHeader = { RawFrameContainer::FRAME_MAGIC, frame.size, frame.size, frame.frameNumber, frame.timestamp };
+
+		fwrite(&frameHeader, sizeof(frameHeader), 1, fileHandle);
+		fwrite(saveBuffer_.data() + frame.offset, 1, frame.size, fileHandle);
+
+		index.push_back({ fileOffset, frame.size, frame.size, frame.frameNumber, frame.timestamp });
+		fileOffset += sizeof(frameHeader) + frame.size;
+	}
+
+	RawFrameContainer::IndexTrailer trailer = { fileOffset, index.size(), RawFrameContainer::INDEX_MAGIC };
+
+	fwrite(index.data(), sizeof(RawFrameContainer::IndexEntry), index.size(), fileHandle);
+	fwrite(&trailer, sizeof(trailer), 1, fileHandle);
+
+	fclose(fileHandle);
+
+	return filePath;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineSink.h"
+#include "Pipeline/Internal/RawFrameContainer.h"
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// Keeps the most recent frames in memory and only writes them to disk when triggered, so that
+// interesting moments can be saved at full quality without writing the whole stream to disk all
+// the time. HEVC input is saved as a raw Annex B stream that always starts at the parameter sets and a keyframe, other
+// formats are saved as uncompressed raw frame containers (see RawFrameContainer.h)
+class CITHRUS_API RingBufferRecorder : public PipelineSink<1>
+{
+public:
+	// Keeps up to bufferDuration seconds of frames as long as they fit in bufferSize bytes of memory.
+	// Saved recordings are placed in directory and reported to onSaved with their file path. The frame size
+	// is stored in raw frame recordings, 0 if unknown
+	RingBufferRecorder(const std::string& directory, const float& bufferDuration, const uint64_t& bufferSize,
+		std::function<void(const std::string&)> onSaved = nullptr, const uint16_t& frameWidth = 0, const uint16_t& frameHeight = 0);
+	// Waits for a save in progress to finish
+	virtual ~RingBufferRecorder();
+
+	virtual void Process() override;
+
+	virtual void OnInputPinsConnected() override;
+
+	// Saves the buffered frames to disk on a background thread. Can be called from any thread. The
+	// frames are copied out of the ring when the next frame arrives. Returns false if the previous
+	// save is still in progress
+	bool Trigger();
+
+	inline uint64_t GetSavedCount() const { return savedRecordings_.load(std::memory_order_relaxed); }
+	// Frames too large to fit in the buffer at all
+	inline uint64_t GetDroppedFrameCount() const { return droppedFrames_.load(std::memory_order_relaxed); }
+
+protected:
+	struct Frame
+	{
+		uint64_t offset;
+		uint32_t size;
+		uint64_t frameNumber;
+		int64_t timestamp;
+		bool keyframe;
+	};
+
+	std::string directory_;
+	int64_t bufferDuration_;
+	std::function<void(const std::string&)> onSaved_;
+
+	std::string format_;
+	bool hevc_;
+
+	uint16_t frameWidth_;
+	uint16_t frameHeight_;
+
+	// The latest HEVC VPS, SPS and PPS including their start codes. Keyframes don't necessarily repeat them,
+	// so they're written at the start of each recording to make it decodable on its own
+	std::vector<uint8_t> parameterSets_[3];
+	std::vector<uint8_t> saveParameterSets_;
+
+	// Frames are stored back to back in a preallocated ring and the oldest ones are evicted to make room
+	std::vector<uint8_t> ring_;
+	std::deque<Frame> frames_;
+	uint64_t writeOffset_;
+	uint64_t frameNumber_;
+
+	// Snapshot of the ring that is written to disk while recording continues
+	std::vector<uint8_t> saveBuffer_;
+	std::vector<Frame> saveFrames_;
+
+	std::atomic<bool> triggered_;
+	std::atomic<bool> saving_;
+
+	std::mutex saveMutex_;
+	std::condition_variable saveCv_;
+	bool saveRequested_;
+	bool stopSaving_;
+	std::thread saveThread_;
+
+	uint32_t saveCount_;
+
+	std::atomic<uint64_t> savedRecordings_;
+	std::atomic<uint64_t> droppedFrames_;
+
+	void StoreFrame(const uint8_t* data, const uint32_t& size, const int64_t& timestamp);
+	// Caches the parameter sets in the frame and returns true if it's a keyframe
+	bool InspectHevcFrame(const uint8_t* data, const uint32_t& size);
+	void EvictExpiredFrames(const int64_t& timestamp);
+	void EvictUndecodableFrames();
+
+	void TakeSnapshot();
+
+	void SaveRecordingsAsync();
+	std::string SaveSnapshot();
+};
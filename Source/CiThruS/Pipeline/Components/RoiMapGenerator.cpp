@@ -0,0 +1,80 @@
+#include "RoiMapGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+
+RoiMapGenerator::RoiMapGenerator(const uint16_t& frameWidth, const uint16_t& frameHeight, const int8_t& roiDeltaQp, const int8_t& backgroundDeltaQp)
+	: frameWidth_(frameWidth), frameHeight_(frameHeight), roiDeltaQp_(roiDeltaQp), backgroundDeltaQp_(backgroundDeltaQp)
+{
+	std::pair<uint16_t, uint16_t> mapResolution = GetMapResolution(frameWidth, frameHeight);
+
+	mapWidth_ = mapResolution.first;
+	mapHeight_ = mapResolution.second;
+
+	outputSize_ = mapWidth_ * mapHeight_;
+	outputData_ = new int8_t[outputSize_];
+
+	GetInputPin<0>().Initialize(this, "binary");
+	GetOutputPin<0>().Initialize(this, "binary");
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+RoiMapGenerator::~RoiMapGenerator()
+{
+	delete[] outputData_;
+	outputData_ = nullptr;
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void RoiMapGenerator::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	if (!inputData || inputSize % sizeof(Rectangle) != 0)
+	{
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
+
+		return;
+	}
+
+	std::fill_n(outputData_, outputSize_, backgroundDeltaQp_);
+
+	const Rectangle* rectangles = reinterpret_cast<const Rectangle*>(inputData);
+	const uint32_t rectangleCount = inputSize / sizeof(Rectangle);
+
+	for (uint32_t i = 0; i < rectangleCount; i++)
+	{
+		const Rectangle& rectangle = rectangles[i];
+
+		// Convert to block coordinates, including every block the rectangle even partially overlaps
+		int firstColumn = std::max(static_cast<int>(std::floor(rectangle.left * frameWidth_ / BLOCK_SIZE)), 0);
+		int lastColumn = std::min(static_cast<int>(std::ceil(rectangle.right * frameWidth_ / BLOCK_SIZE)), static_cast<int>(mapWidth_));
+		int firstRow = std::max(static_cast<int>(std::floor(rectangle.top * frameHeight_ / BLOCK_SIZE)), 0);
+		int lastRow = std::min(static_cast<int>(std::ceil(rectangle.bottom * frameHeight_ / BLOCK_SIZE)), static_cast<int>(mapHeight_));
+
+		if (firstColumn >= lastColumn)
+		{
+			continue;
+		}
+
+		for (int row = firstRow; row < lastRow; row++)
+		{
+			std::fill(outputData_ + row * mapWidth_ + firstColumn, outputData_ + row * mapWidth_ + lastColumn, roiDeltaQp_);
+		}
+	}
+
+	GetOutputPin<0>().SetData(reinterpret_cast<uint8_t*>(outputData_));
+	GetOutputPin<0>().SetSize(outputSize_);
+}
+
+std::pair<uint16_t, uint16_t> RoiMapGenerator::GetMapResolution(const uint16_t& frameWidth, const uint16_t& frameHeight)
+{
+	// Partial blocks at the right and bottom edges count as whole blocks
+	return { (frameWidth + BLOCK_SIZE - 1) / BLOCK_SIZE, (frameHeight + BLOCK_SIZE - 1) / BLOCK_SIZE };
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineFilter.h"
+
+#include <utility>
+
+// Generates a region of interest map for HevcEncoderWithRoi from a list of image space rectangles.
+// The map contains a delta QP for each block of the image: blocks overlapping any of the rectangles
+// get roiDeltaQp and the rest of the image gets backgroundDeltaQp
+class CITHRUS_API RoiMapGenerator : public PipelineFilter<1, 1>
+{
+public:
+	// Normalized image coordinates: (0, 0) is the top left corner and (1, 1) is the bottom right corner.
+	// The input data is a tightly packed array of these
+	struct Rectangle
+	{
+		float left;
+		float top;
+		float right;
+		float bottom;
+	};
+
+	RoiMapGenerator(const uint16_t& frameWidth, const uint16_t& frameHeight, const int8_t& roiDeltaQp, const int8_t& backgroundDeltaQp);
+	virtual ~RoiMapGenerator();
+
+	virtual void Process() override;
+
+	// <width, height> of the map in blocks
+	static std::pair<uint16_t, uint16_t> GetMapResolution(const uint16_t& frameWidth, const uint16_t& frameHeight);
+
+protected:
+	// One delta QP per HEVC coding tree unit
+	static constexpr uint16_t BLOCK_SIZE = 64;
+
+	int8_t* outputData_;
+	uint32_t outputSize_;
+
+	uint16_t frameWidth_;
+	uint16_t frameHeight_;
+	uint16_t mapWidth_;
+	uint16_t mapHeight_;
+
+	int8_t roiDeltaQp_;
+	int8_t backgroundDeltaQp_;
+};
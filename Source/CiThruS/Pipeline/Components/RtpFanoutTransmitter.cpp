@@ -0,0 +1,131 @@
+#include "RtpFanoutTransmitter.h"
+#include "Misc/Debug.h"
+
+RtpFanoutTransmitter::RtpFanoutTransmitter()
+{
+	GetInputPin<0>().Initialize(this, "hevc");
+}
+
+RtpFanoutTransmitter::RtpFanoutTransmitter(const std::string& ip, const int& dstPort) : RtpFanoutTransmitter()
+{
+	AddDestination(ip, dstPort);
+}
+
+RtpFanoutTransmitter::~RtpFanoutTransmitter()
+{
+	std::lock_guard<std::mutex> lock(destinationMutex_);
+
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	for (auto it = destinations_.begin(); it != destinations_.end(); it++)
+	{
+		DestroyDestination(it->second);
+	}
+
+	destinations_.clear();
+#endif // CITHRUS_UVGRTP_AVAILABLE
+}
+
+void RtpFanoutTransmitter::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	size_t inputSize = GetInputPin<0>().GetSize();
+
+	if (!inputData || inputSize == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(destinationMutex_);
+
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	for (auto it = destinations_.begin(); it != destinations_.end(); it++)
+	{
+		// This const_cast should be okay as there should be no reason for uvgRTP to ever modify the input data
+		if (it->second.stream->push_frame(const_cast<uint8_t*>(inputData), inputSize, RTP_NO_FLAGS) != RTP_ERROR::RTP_OK)
+		{
+			Debug::Log("Failed to push frame to " + it->first.first + ":" + std::to_string(it->first.second));
+		}
+	}
+#endif // CITHRUS_UVGRTP_AVAILABLE
+}
+
+bool RtpFanoutTransmitter::AddDestination(const std::string& ip, const int& dstPort)
+{
+	std::lock_guard<std::mutex> lock(destinationMutex_);
+
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	if (destinations_.find({ ip, dstPort }) != destinations_.end())
+	{
+		return false;
+	}
+
+	Destination destination;
+
+	destination.session = streamContext_.create_session(ip);
+	destination.stream = destination.session ? destination.session->create_stream(0, dstPort, RTP_FORMAT_H265, RCE_NO_FLAGS) : nullptr;
+
+	if (!destination.stream)
+	{
+		Debug::Log("Failed to create RTP stream");
+
+		DestroyDestination(destination);
+
+		return false;
+	}
+
+	destinations_.insert({ { ip, dstPort }, destination });
+
+	return true;
+#else
+	return false;
+#endif // CITHRUS_UVGRTP_AVAILABLE
+}
+
+bool RtpFanoutTransmitter::RemoveDestination(const std::string& ip, const int& dstPort)
+{
+	std::lock_guard<std::mutex> lock(destinationMutex_);
+
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	auto it = destinations_.find({ ip, dstPort });
+
+	if (it == destinations_.end())
+	{
+		return false;
+	}
+
+	DestroyDestination(it->second);
+	destinations_.erase(it);
+
+	return true;
+#else
+	return false;
+#endif // CITHRUS_UVGRTP_AVAILABLE
+}
+
+size_t RtpFanoutTransmitter::GetDestinationCount()
+{
+	std::lock_guard<std::mutex> lock(destinationMutex_);
+
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	return destinations_.size();
+#else
+	return 0;
+#endif // CITHRUS_UVGRTP_AVAILABLE
+}
+
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+void RtpFanoutTransmitter::DestroyDestination(Destination& destination)
+{
+	if (destination.stream)
+	{
+		destination.session->destroy_stream(destination.stream);
+		destination.stream = nullptr;
+	}
+
+	if (destination.session)
+	{
+		streamContext_.destroy_session(destination.session);
+		destination.session = nullptr;
+	}
+}
+#endif // CITHRUS_UVGRTP_AVAILABLE
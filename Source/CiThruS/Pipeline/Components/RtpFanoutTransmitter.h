@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Optional/UvgRtp.h"
+#include "Pipeline/Internal/PipelineSink.h"
+
+#include "CoreMinimal.h"
+
+#include <string>
+#include <map>
+#include <mutex>
+#include <utility>
+
+// Transmits the same data in RTP streams to any number of destinations, which can be added and
+// removed while the pipeline is running. This way serving another viewer doesn't need another encoder
+class CITHRUS_API RtpFanoutTransmitter : public PipelineSink<1>
+{
+public:
+	RtpFanoutTransmitter();
+	RtpFanoutTransmitter(const std::string& ip, const int& dstPort);
+	virtual ~RtpFanoutTransmitter();
+
+	virtual void Process() override;
+
+	// These can be called from any thread. They return false if the destination already exists or doesn't exist respectively
+	bool AddDestination(const std::string& ip, const int& dstPort);
+	bool RemoveDestination(const std::string& ip, const int& dstPort);
+
+	size_t GetDestinationCount();
+
+protected:
+	// Prevents destinations from being changed while data is being sent to them
+	std::mutex destinationMutex_;
+
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	struct Destination
+	{
+		uvgrtp::session* session;
+		uvgrtp::media_stream* stream;
+	};
+
+	uvgrtp::context streamContext_;
+
+	// <ip, port>
+	std::map<std::pair<std::string, int>, Destination> destinations_;
+
+	void DestroyDestination(Destination& destination);
+#endif // CITHRUS_UVGRTP_AVAILABLE
+};
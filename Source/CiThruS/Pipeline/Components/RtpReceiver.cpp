@@ -1,7 +1,21 @@
 #include "RtpReceiver.h"
 #include "Misc/Debug.h"
 
-RtpReceiver::RtpReceiver(const std::string& ip, const int& srcPort) : destroyed_(false)
+// HEVC NAL unit types
+const uint8_t NAL_TYPE_IRAP_FIRST = 16;
+const uint8_t NAL_TYPE_IRAP_LAST = 23;
+const uint8_t NAL_TYPE_VPS = 32;
+const uint8_t NAL_TYPE_PPS = 34;
+
+// Frames taken from the receive buffer beyond the jitter buffer size. One picture can consist of several NAL units
+// with the same timestamp, which all need to be in the jitter buffer for it to sort them correctly
+const uint8_t JITTER_BUFFER_MARGIN = 8;
+
+RtpReceiver::RtpReceiver(const std::string& ip, const int& srcPort, const uint16_t& receiveBufferSize, const uint8_t& jitterBufferSize)
+	: jitterBufferSize_(jitterBufferSize), overflowed_(false), waitingForKeyframe_(false)
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	, receiveBuffer_(receiveBufferSize)
+#endif // CITHRUS_UVGRTP_AVAILABLE
 {
 #ifdef CITHRUS_UVGRTP_AVAILABLE
 	currentFrame_ = nullptr;
@@ -25,38 +39,40 @@ RtpReceiver::RtpReceiver(const std::string& ip, const int& srcPort) : destroyed_
 
 RtpReceiver::~RtpReceiver()
 {
-	queueMutex_.lock();
+#ifdef CITHRUS_UVGRTP_AVAILABLE
+	// This stops the receive thread, so nothing is pushed to the receive buffer after this
+	if (stream_)
+	{
+		streamSession_->destroy_stream(stream_);
+		stream_ = nullptr;
+	}
 
-	destroyed_ = true;
+	if (streamSession_)
+	{
+		streamContext_.destroy_session(streamSession_);
+		streamSession_ = nullptr;
+	}
 
-#ifdef CITHRUS_UVGRTP_AVAILABLE
 	if (currentFrame_)
 	{
 		uvgrtp::frame::dealloc_frame(currentFrame_);
 		currentFrame_ = nullptr;
 	}
 
-	while (!frameQueue_.empty())
-	{
-		uvgrtp::frame::dealloc_frame(frameQueue_.front());
+	uvgrtp::frame::rtp_frame* frame = nullptr;
 
-		frameQueue_.pop();
-	}
-	
-	if (stream_)
+	while (receiveBuffer_.TryPop(frame))
 	{
-		streamSession_->destroy_stream(stream_);
-		stream_ = nullptr;
+		uvgrtp::frame::dealloc_frame(frame);
 	}
 
-	if (streamSession_)
+	for (uvgrtp::frame::rtp_frame* bufferedFrame : jitterBuffer_)
 	{
-		streamContext_.destroy_session(streamSession_);
-		streamSession_ = nullptr;
+		uvgrtp::frame::dealloc_frame(bufferedFrame);
 	}
-#endif // CITHRUS_UVGRTP_AVAILABLE
 
-	queueMutex_.unlock();
+	jitterBuffer_.clear();
+#endif // CITHRUS_UVGRTP_AVAILABLE
 
 	GetOutputPin<0>().SetData(nullptr);
 	GetOutputPin<0>().SetSize(0);
@@ -65,23 +81,43 @@ RtpReceiver::~RtpReceiver()
 void RtpReceiver::Process()
 {
 #ifdef CITHRUS_UVGRTP_AVAILABLE
-	queueMutex_.lock();
+	uvgrtp::frame::rtp_frame* frame = nullptr;
+
+	// Frames were lost, so the frames that depend on them can't be decoded correctly anyway. Everything waiting in
+	// the receive buffer is taken so that the newest keyframe can be found
+	const bool overflowed = overflowed_.exchange(false);
 
-	if (!frameQueue_.empty())
+	// Otherwise frames are only taken while the jitter buffer has room for them. If processing falls behind, the
+	// receive buffer fills up and overflows instead of the latency growing without a limit
+	while ((overflowed || jitterBuffer_.size() < jitterBufferSize_ + JITTER_BUFFER_MARGIN) && receiveBuffer_.TryPop(frame))
 	{
-		if (currentFrame_)
-		{
-			uvgrtp::frame::dealloc_frame(currentFrame_);
-		}
+		InsertIntoJitterBuffer(frame);
+	}
+
+	if (overflowed)
+	{
+		SkipToNewestKeyframe();
+	}
+
+	if (currentFrame_)
+	{
+		uvgrtp::frame::dealloc_frame(currentFrame_);
+		currentFrame_ = nullptr;
+	}
 
-		currentFrame_ = frameQueue_.front();
-		frameQueue_.pop();
+	if (jitterBuffer_.size() <= jitterBufferSize_)
+	{
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
 
-		GetOutputPin<0>().SetData(currentFrame_->payload);
-		GetOutputPin<0>().SetSize(currentFrame_->payload_len);
+		return;
 	}
 
-	queueMutex_.unlock();
+	currentFrame_ = jitterBuffer_.front();
+	jitterBuffer_.pop_front();
+
+	GetOutputPin<0>().SetData(currentFrame_->payload);
+	GetOutputPin<0>().SetSize(currentFrame_->payload_len);
 #endif // CITHRUS_UVGRTP_AVAILABLE
 }
 
@@ -95,17 +131,106 @@ void RtpReceiver::ReceiveAsync(void* args, uvgrtp::frame::rtp_frame* frame)
 
 	RtpReceiver* receiver = static_cast<RtpReceiver*>(args);
 
-	receiver->queueMutex_.lock();
+	if (!receiver->receiveBuffer_.TryPush(frame))
+	{
+		uvgrtp::frame::dealloc_frame(frame);
+
+		receiver->overflowed_ = true;
+	}
+}
+
+void RtpReceiver::InsertIntoJitterBuffer(uvgrtp::frame::rtp_frame* frame)
+{
+	if (waitingForKeyframe_)
+	{
+		uint8_t nalType = GetNalType(frame);
+
+		// Parameter sets are sent right before keyframes
+		if ((nalType < NAL_TYPE_IRAP_FIRST || nalType > NAL_TYPE_IRAP_LAST) && (nalType < NAL_TYPE_VPS || nalType > NAL_TYPE_PPS))
+		{
+			uvgrtp::frame::dealloc_frame(frame);
+
+			return;
+		}
+
+		waitingForKeyframe_ = false;
+	}
+
+	// Frames usually arrive in order, so search from the back. The comparison handles timestamp wraparound,
+	// and frames with the same timestamp (NAL units of the same picture) keep their arrival order
+	auto it = jitterBuffer_.end();
 
-	if (!receiver->destroyed_)
+	while (it != jitterBuffer_.begin() && static_cast<int32_t>(frame->header.timestamp - (*(it - 1))->header.timestamp) < 0)
 	{
-		receiver->frameQueue_.push(frame);
+		it--;
 	}
-	else
+
+	jitterBuffer_.insert(it, frame);
+}
+
+void RtpReceiver::SkipToNewestKeyframe()
+{
+	int newestKeyframe = -1;
+
+	for (int i = jitterBuffer_.size() - 1; i >= 0; i--)
 	{
-		uvgrtp::frame::dealloc_frame(frame);
+		uint8_t nalType = GetNalType(jitterBuffer_[i]);
+
+		if (nalType >= NAL_TYPE_IRAP_FIRST && nalType <= NAL_TYPE_IRAP_LAST)
+		{
+			newestKeyframe = i;
+
+			break;
+		}
 	}
-	
-	receiver->queueMutex_.unlock();
+
+	if (newestKeyframe == -1)
+	{
+		// Drop everything and wait for the next keyframe to arrive
+		for (uvgrtp::frame::rtp_frame* frame : jitterBuffer_)
+		{
+			uvgrtp::frame::dealloc_frame(frame);
+		}
+
+		jitterBuffer_.clear();
+		waitingForKeyframe_ = true;
+
+		return;
+	}
+
+	// Keep the parameter sets that belong to the same picture as the keyframe
+	const uint32_t keyframeTimestamp = jitterBuffer_[newestKeyframe]->header.timestamp;
+
+	while (jitterBuffer_.front()->header.timestamp != keyframeTimestamp)
+	{
+		uvgrtp::frame::dealloc_frame(jitterBuffer_.front());
+		jitterBuffer_.pop_front();
+	}
+}
+
+uint8_t RtpReceiver::GetNalType(const uvgrtp::frame::rtp_frame* frame)
+{
+	const uint8_t* payload = frame->payload;
+	size_t payloadLength = frame->payload_len;
+
+	// Skip the start code if there is one
+	if (payloadLength >= 4 && payload[0] == 0 && payload[1] == 0 && payload[2] == 0 && payload[3] == 1)
+	{
+		payload += 4;
+		payloadLength -= 4;
+	}
+	else if (payloadLength >= 3 && payload[0] == 0 && payload[1] == 0 && payload[2] == 1)
+	{
+		payload += 3;
+		payloadLength -= 3;
+	}
+
+	if (payloadLength == 0)
+	{
+		// Not a valid NAL unit type
+		return 0xFF;
+	}
+
+	return (payload[0] >> 1) & 0x3F;
 }
 #endif // CITHRUS_UVGRTP_AVAILABLE
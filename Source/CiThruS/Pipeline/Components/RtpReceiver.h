@@ -2,26 +2,32 @@
 
 #include "Optional/UvgRtp.h"
 #include "Pipeline/Internal/PipelineSource.h"
+#include "Misc/SpscRingBuffer.h"
 
 #include "CoreMinimal.h"
 
 #include <string>
-#include <queue>
-#include <mutex>
+#include <deque>
+#include <atomic>
 
 // Receives data from an RTP stream. Currently HEVC data only
 class CITHRUS_API RtpReceiver : public PipelineSource<1>
 {
 public:
-	RtpReceiver(const std::string& ip, const int& srcPort);
+	// receiveBufferSize is the maximum number of received frames waiting to be processed. If the buffer overflows,
+	// frames are skipped until the newest keyframe. jitterBufferSize is the number of frames held back to fix
+	// the order of frames that arrive out of order, at the cost of latency
+	RtpReceiver(const std::string& ip, const int& srcPort, const uint16_t& receiveBufferSize = 64, const uint8_t& jitterBufferSize = 0);
 	virtual ~RtpReceiver();
 
 	virtual void Process() override;
 
 protected:
-	bool destroyed_;
+	uint8_t jitterBufferSize_;
 
-	std::mutex queueMutex_;
+	// Set by the receive thread when a frame had to be dropped
+	std::atomic<bool> overflowed_;
+	bool waitingForKeyframe_;
 
 #ifdef CITHRUS_UVGRTP_AVAILABLE
 	uvgrtp::context streamContext_;
@@ -29,8 +35,18 @@ protected:
 	uvgrtp::media_stream* stream_;
 
 	uvgrtp::frame::rtp_frame* currentFrame_;
-	std::queue<uvgrtp::frame::rtp_frame*> frameQueue_;
+
+	// Frames are passed from the receive thread through here without locking
+	SpscRingBuffer<uvgrtp::frame::rtp_frame*> receiveBuffer_;
+	// Frames waiting to be output, ordered by RTP timestamp
+	std::deque<uvgrtp::frame::rtp_frame*> jitterBuffer_;
 
 	static void ReceiveAsync(void* args, uvgrtp::frame::rtp_frame* frame);
+
+	void InsertIntoJitterBuffer(uvgrtp::frame::rtp_frame* frame);
+	void SkipToNewestKeyframe();
+
+	// The HEVC NAL unit type of the frame's payload
+	static uint8_t GetNalType(const uvgrtp::frame::rtp_frame* frame);
 #endif // CITHRUS_UVGRTP_AVAILABLE
 };
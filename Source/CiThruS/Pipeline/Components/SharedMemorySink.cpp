@@ -0,0 +1,141 @@
+#include "SharedMemorySink.h"
+#include "Pipeline/Internal/SharedFrameRing.h"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace
+{
+	// Size of one pixel in the first plane of the format, or 0 if the format doesn't consist of pixels
+	uint32_t GetBytesPerPixel(const std::string& format)
+	{
+		if (format == "rgba" || format == "bgra" || format == "gray32f")
+		{
+			return 4;
+		}
+		else if (format == "rgba32f")
+		{
+			return 16;
+		}
+		else if (format == "yuv420")
+		{
+			return 1;
+		}
+
+		return 0;
+	}
+}
+
+SharedMemorySink::SharedMemorySink(const std::string& name, const uint32_t& frameWidth, const uint32_t& frameHeight, const uint32_t& slotCount, const uint32_t& slotSize)
+	: region_(nullptr), segment_(nullptr), slotCount_(slotCount), slotSize_(slotSize), frameWidth_(frameWidth), frameHeight_(frameHeight), sequence_(0)
+{
+	if (slotCount_ < 2)
+	{
+		throw std::invalid_argument("Shared memory ring must have at least two slots");
+	}
+
+	if (slotSize_ == 0)
+	{
+		throw std::invalid_argument("Shared memory slot size cannot be 0");
+	}
+
+	region_ = FPlatformMemory::MapNamedSharedMemoryRegion(
+		FString(name.c_str()), true,
+		FPlatformMemory::ESharedMemoryAccess::Read | FPlatformMemory::ESharedMemoryAccess::Write,
+		SharedFrameRing::GetSegmentSize(slotCount_, slotSize_));
+
+	if (!region_)
+	{
+		throw std::runtime_error("Failed to create shared memory segment " + name);
+	}
+
+	segment_ = static_cast<uint8_t*>(region_->GetAddress());
+
+	SharedFrameRing::Header* header = new (segment_) SharedFrameRing::Header();
+
+	header->version = SharedFrameRing::VERSION;
+	header->slotCount = slotCount_;
+	header->slotSize = slotSize_;
+	header->width = frameWidth_;
+	header->height = frameHeight_;
+	header->stride = 0;
+	header->latestSequence.store(0, std::memory_order_relaxed);
+
+	for (uint32_t i = 0; i < slotCount_; i++)
+	{
+		SharedFrameRing::Slot* slot = new (SharedFrameRing::GetSlot(segment_, i)) SharedFrameRing::Slot();
+
+		slot->sequence.store(0, std::memory_order_relaxed);
+		slot->size = 0;
+		slot->timestamp = 0;
+	}
+
+	GetInputPin<0>().Initialize(this);
+}
+
+SharedMemorySink::~SharedMemorySink()
+{
+	if (region_)
+	{
+		// Tell readers that the segment is no longer being written
+		reinterpret_cast<SharedFrameRing::Header*>(segment_)->magic.store(0, std::memory_order_release);
+
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(region_);
+
+		region_ = nullptr;
+		segment_ = nullptr;
+	}
+}
+
+void SharedMemorySink::OnInputPinsConnected()
+{
+	SharedFrameRing::Header* header = reinterpret_cast<SharedFrameRing::Header*>(segment_);
+
+	std::string format = GetInputPin<0>().GetFormat();
+
+	if (format.size() >= SharedFrameRing::FORMAT_LENGTH)
+	{
+		throw std::invalid_argument("Format name " + format + " is too long to fit in shared memory");
+	}
+
+	memset(header->format, 0, SharedFrameRing::FORMAT_LENGTH);
+	memcpy(header->format, format.data(), format.size());
+
+	header->stride = frameWidth_ * GetBytesPerPixel(format);
+
+	// The header is complete now, readers can start using the segment
+	header->magic.store(SharedFrameRing::MAGIC, std::memory_order_release);
+}
+
+void SharedMemorySink::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	if (!inputData || inputSize == 0)
+	{
+		return;
+	}
+
+	if (inputSize > slotSize_)
+	{
+		throw std::runtime_error("Frame of " + std::to_string(inputSize) + " bytes does not fit in a shared memory slot of " + std::to_string(slotSize_) + " bytes");
+	}
+
+	sequence_++;
+
+	const uint32_t slotIndex = sequence_ % slotCount_;
+	SharedFrameRing::Slot* slot = SharedFrameRing::GetSlot(segment_, slotIndex);
+
+	// Mark the slot as being written so that readers don't mistake it for the frame that was there before
+	slot->sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	memcpy(SharedFrameRing::GetSlotData(segment_, slotIndex), inputData, inputSize);
+
+	slot->size = inputSize;
+	slot->timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+
+	slot->sequence.store(sequence_, std::memory_order_release);
+	reinterpret_cast<SharedFrameRing::Header*>(segment_)->latestSequence.store(sequence_, std::memory_order_release);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+#include "Pipeline/Internal/PipelineSink.h"
+
+#include <string>
+
+// Publishes frames of any format to other processes on the same machine through a ring of slots
+// in a named shared memory segment, see SharedFrameRing.h for the layout. Each frame is copied once
+// into the next slot. Readers that fall more than slotCount frames behind will miss frames
+class CITHRUS_API SharedMemorySink : public PipelineSink<1>
+{
+public:
+	// slotSize is the maximum size of a frame in bytes. The frame size is published to readers
+	// in the segment header and can be 0 for data that isn't made of images
+	SharedMemorySink(const std::string& name, const uint32_t& frameWidth, const uint32_t& frameHeight, const uint32_t& slotCount, const uint32_t& slotSize);
+	virtual ~SharedMemorySink();
+
+	virtual void Process() override;
+
+	virtual void OnInputPinsConnected() override;
+
+protected:
+	FSharedMemoryRegion* region_;
+	uint8_t* segment_;
+
+	uint32_t slotCount_;
+	uint32_t slotSize_;
+
+	uint32_t frameWidth_;
+	uint32_t frameHeight_;
+
+	uint64_t sequence_;
+};
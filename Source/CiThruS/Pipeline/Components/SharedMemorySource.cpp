@@ -0,0 +1,193 @@
+#include "SharedMemorySource.h"
+#include "Pipeline/Internal/SharedFrameRing.h"
+
+#include <stdexcept>
+
+SharedMemorySource::SharedMemorySource(const std::string& name, const std::string& format, const bool& copyFrames)
+	: name_(name), format_(format), copyFrames_(copyFrames), region_(nullptr), segment_(nullptr), frameWidth_(0), frameHeight_(0), frameStride_(0), outputData_(nullptr), outputSize_(0),
+	lastSequence_(0), lastSlotIndex_(0), frameTimestamp_(0), outputInSlot_(false), skippedFrames_(0), overwrittenFrames_(0)
+{
+	GetOutputPin<0>().Initialize(this, format_);
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+SharedMemorySource::~SharedMemorySource()
+{
+	Close();
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void SharedMemorySource::Process()
+{
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+
+	if (!segment_ && !TryOpen())
+	{
+		return;
+	}
+
+	const SharedFrameRing::Header* header = reinterpret_cast<const SharedFrameRing::Header*>(segment_);
+
+	// The sink has been destroyed, start over in case a new one is created with the same name
+	if (header->magic.load(std::memory_order_acquire) != SharedFrameRing::MAGIC)
+	{
+		Close();
+
+		return;
+	}
+
+	// In zero-copy mode the previous output was read directly from its slot. If the sink has already
+	// reused the slot, the frame may have changed while it was being processed
+	if (outputInSlot_)
+	{
+		if (SharedFrameRing::GetSlot(segment_, lastSlotIndex_)->sequence.load(std::memory_order_acquire) != lastSequence_)
+		{
+			overwrittenFrames_.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		outputInSlot_ = false;
+	}
+
+	const uint64_t sequence = header->latestSequence.load(std::memory_order_acquire);
+
+	if (sequence == lastSequence_)
+	{
+		return;
+	}
+
+	// The sink restarted its sequence numbering
+	if (sequence < lastSequence_)
+	{
+		lastSequence_ = 0;
+	}
+
+	const uint32_t slotIndex = sequence % header->slotCount;
+	SharedFrameRing::Slot* slot = SharedFrameRing::GetSlot(segment_, slotIndex);
+
+	if (slot->sequence.load(std::memory_order_acquire) != sequence)
+	{
+		// The sink is already writing a newer frame into the slot, try again next time
+		return;
+	}
+
+	const uint32_t size = slot->size;
+	const int64_t timestamp = slot->timestamp;
+	uint8_t* data = SharedFrameRing::GetSlotData(segment_, slotIndex);
+
+	if (copyFrames_)
+	{
+		memcpy(outputData_, data, size);
+
+		// Make sure the sink didn't start overwriting the slot during the copy
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		if (slot->sequence.load(std::memory_order_relaxed) != sequence)
+		{
+			overwrittenFrames_.fetch_add(1, std::memory_order_relaxed);
+
+			return;
+		}
+
+		data = outputData_;
+	}
+
+	if (lastSequence_ != 0 && sequence > lastSequence_ + 1)
+	{
+		skippedFrames_.fetch_add(sequence - lastSequence_ - 1, std::memory_order_relaxed);
+	}
+
+	lastSequence_ = sequence;
+	lastSlotIndex_ = slotIndex;
+	frameTimestamp_ = timestamp;
+	outputInSlot_ = !copyFrames_;
+
+	GetOutputPin<0>().SetData(data);
+	GetOutputPin<0>().SetSize(size);
+}
+
+bool SharedMemorySource::TryOpen()
+{
+	// Map only the header first because the size of the rest of the segment isn't known yet
+	FSharedMemoryRegion* headerRegion = FPlatformMemory::MapNamedSharedMemoryRegion(
+		FString(name_.c_str()), false, FPlatformMemory::ESharedMemoryAccess::Read, sizeof(SharedFrameRing::Header));
+
+	if (!headerRegion)
+	{
+		return false;
+	}
+
+	const SharedFrameRing::Header* header = static_cast<const SharedFrameRing::Header*>(headerRegion->GetAddress());
+
+	if (header->magic.load(std::memory_order_acquire) != SharedFrameRing::MAGIC)
+	{
+		// The sink is still initializing the segment
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(headerRegion);
+
+		return false;
+	}
+
+	const uint32_t version = header->version;
+	const uint32_t slotCount = header->slotCount;
+	const uint32_t slotSize = header->slotSize;
+	const std::string format(header->format, strnlen(header->format, SharedFrameRing::FORMAT_LENGTH));
+	const uint32_t width = header->width;
+	const uint32_t height = header->height;
+	const uint32_t stride = header->stride;
+
+	FPlatformMemory::UnmapNamedSharedMemoryRegion(headerRegion);
+
+	if (version != SharedFrameRing::VERSION)
+	{
+		throw std::runtime_error("Shared memory segment " + name_ + " has unsupported version " + std::to_string(version));
+	}
+
+	if (format != format_)
+	{
+		throw std::runtime_error("Shared memory segment " + name_ + " contains " + format + " data, expected " + format_);
+	}
+
+	region_ = FPlatformMemory::MapNamedSharedMemoryRegion(
+		FString(name_.c_str()), false, FPlatformMemory::ESharedMemoryAccess::Read, SharedFrameRing::GetSegmentSize(slotCount, slotSize));
+
+	if (!region_)
+	{
+		return false;
+	}
+
+	segment_ = static_cast<uint8_t*>(region_->GetAddress());
+
+	frameWidth_ = width;
+	frameHeight_ = height;
+	frameStride_ = stride;
+
+	if (copyFrames_)
+	{
+		outputSize_ = slotSize;
+		outputData_ = new uint8_t[outputSize_];
+	}
+
+	lastSequence_ = 0;
+	outputInSlot_ = false;
+
+	return true;
+}
+
+void SharedMemorySource::Close()
+{
+	if (region_)
+	{
+		FPlatformMemory::UnmapNamedSharedMemoryRegion(region_);
+
+		region_ = nullptr;
+		segment_ = nullptr;
+	}
+
+	delete[] outputData_;
+	outputData_ = nullptr;
+	outputSize_ = 0;
+}
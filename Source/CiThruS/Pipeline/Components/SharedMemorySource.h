@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformMemory.h"
+#include "Pipeline/Internal/PipelineSource.h"
+
+#include <string>
+#include <atomic>
+
+// Reads frames published by a SharedMemorySink, possibly in another process. Outputs the newest frame
+// each time it's processed, or nothing if there is no new frame. Waits for the segment to appear if
+// the sink hasn't been created yet.
+//
+// By default the output points straight into shared memory without copying. The sink may then overwrite
+// the frame while it's still being processed if the rest of the pipeline falls slotCount frames behind.
+// Such frames are counted in GetOverwrittenFrameCount. With copyFrames, each frame is copied out first
+// and overwritten frames are discarded instead
+class CITHRUS_API SharedMemorySource : public PipelineSource<1>
+{
+public:
+	SharedMemorySource(const std::string& name, const std::string& format, const bool& copyFrames = false);
+	virtual ~SharedMemorySource();
+
+	virtual void Process() override;
+
+	// Frames that were skipped because newer ones were available
+	inline uint64_t GetSkippedFrameCount() const { return skippedFrames_.load(std::memory_order_relaxed); }
+	// Frames that were overwritten by the sink before they were finished with
+	inline uint64_t GetOverwrittenFrameCount() const { return overwrittenFrames_.load(std::memory_order_relaxed); }
+
+	// steady_clock nanoseconds at which the frame currently in the output was written into shared memory
+	inline int64_t GetFrameTimestamp() const { return frameTimestamp_; }
+
+	// Frame size published by the sink, 0 until the segment has been opened or if the frames are not images
+	inline uint32_t GetFrameWidth() const { return frameWidth_; }
+	inline uint32_t GetFrameHeight() const { return frameHeight_; }
+	// Bytes between the starts of consecutive rows in the first plane
+	inline uint32_t GetFrameStride() const { return frameStride_; }
+
+protected:
+	std::string name_;
+	std::string format_;
+	bool copyFrames_;
+
+	FSharedMemoryRegion* region_;
+	uint8_t* segment_;
+
+	uint32_t frameWidth_;
+	uint32_t frameHeight_;
+	uint32_t frameStride_;
+
+	uint8_t* outputData_;
+	uint32_t outputSize_;
+
+	uint64_t lastSequence_;
+	uint32_t lastSlotIndex_;
+	int64_t frameTimestamp_;
+	// Whether the previous output pointed straight into slot lastSlotIndex_
+	bool outputInSlot_;
+
+	std::atomic<uint64_t> skippedFrames_;
+	std::atomic<uint64_t> overwrittenFrames_;
+
+	bool TryOpen();
+	void Close();
+};
@@ -0,0 +1,39 @@
+#include "TestPatternAnalyzer.h"
+#include "TestPatternGenerator.h"
+
+TestPatternAnalyzer::TestPatternAnalyzer(const uint16_t& frameWidth, const uint16_t& frameHeight, const std::function<void(const uint32_t& frameNumber)>& onFrameReceived)
+	: frameWidth_(frameWidth), frameHeight_(frameHeight), onFrameReceived_(onFrameReceived)
+{
+	GetInputPin<0>().Initialize(this, "yuv420");
+}
+
+TestPatternAnalyzer::~TestPatternAnalyzer()
+{
+
+}
+
+void TestPatternAnalyzer::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	if (!inputData || inputSize != frameWidth_ * frameHeight_ * 3 / 2)
+	{
+		return;
+	}
+
+	const uint16_t blockWidth = frameWidth_ / TestPatternGenerator::STAMP_BITS;
+	const uint8_t* row = inputData + TestPatternGenerator::STAMP_HEIGHT / 2 * frameWidth_;
+
+	uint32_t frameNumber = 0;
+
+	// Sample the middle of each block, far enough from the edges to be unaffected by compression artifacts
+	for (int i = 0; i < TestPatternGenerator::STAMP_BITS; i++)
+	{
+		uint8_t sample = row[i * blockWidth + blockWidth / 2];
+
+		frameNumber = (frameNumber << 1) | (sample > (TestPatternGenerator::STAMP_BLACK + TestPatternGenerator::STAMP_WHITE) / 2 ? 1 : 0);
+	}
+
+	onFrameReceived_(frameNumber);
+}
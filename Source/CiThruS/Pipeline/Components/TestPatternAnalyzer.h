@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineSink.h"
+
+#include <functional>
+
+// Reads the frame number stamped by TestPatternGenerator from received YUV 4:2:0 images
+class CITHRUS_API TestPatternAnalyzer : public PipelineSink<1>
+{
+public:
+	// onFrameReceived is called with the frame number of each received frame. Only the lowest
+	// TestPatternGenerator::STAMP_BITS bits of the frame number are stamped
+	TestPatternAnalyzer(const uint16_t& frameWidth, const uint16_t& frameHeight, const std::function<void(const uint32_t& frameNumber)>& onFrameReceived);
+	virtual ~TestPatternAnalyzer();
+
+	virtual void Process() override;
+
+protected:
+	uint16_t frameWidth_;
+	uint16_t frameHeight_;
+
+	std::function<void(const uint32_t& frameNumber)> onFrameReceived_;
+};
@@ -0,0 +1,91 @@
+#include "TestPatternGenerator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+TestPatternGenerator::TestPatternGenerator(
+	const uint16_t& frameWidth, const uint16_t& frameHeight, const uint32_t& frameCount, const float& frameRate,
+	const std::function<void(const uint32_t& frameNumber)>& onFrameGenerated)
+	: frameWidth_(frameWidth), frameHeight_(frameHeight), frameCount_(frameCount), frameNumber_(0),
+	pacer_(frameRate), onFrameGenerated_(onFrameGenerated)
+{
+	if (frameWidth_ % 2 != 0 || frameHeight_ % 2 != 0)
+	{
+		throw std::runtime_error("The width and height of YUV 4:2:0 data must be divisible by 2");
+	}
+
+	if (frameWidth_ < STAMP_BITS * 2 || frameHeight_ < STAMP_HEIGHT)
+	{
+		throw std::invalid_argument("The frame is too small for the frame number stamp");
+	}
+
+	outputSize_ = frameWidth_ * frameHeight_ * 3 / 2;
+	outputData_ = new uint8_t[outputSize_];
+
+	GetOutputPin<0>().Initialize(this, "yuv420");
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+TestPatternGenerator::~TestPatternGenerator()
+{
+	delete[] outputData_;
+	outputData_ = nullptr;
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void TestPatternGenerator::Process()
+{
+	if (frameCount_ != 0 && frameNumber_ >= frameCount_)
+	{
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
+
+		return;
+	}
+
+	pacer_.WaitForNextFrame();
+
+	const uint32_t lumaSize = frameWidth_ * frameHeight_;
+
+	// Diagonal gradient that moves a bit every frame, so that there is motion for the encoder to deal with
+	for (int i = 0; i < frameHeight_; i++)
+	{
+		uint8_t* row = outputData_ + i * frameWidth_;
+
+		for (int j = 0; j < frameWidth_; j++)
+		{
+			row[j] = static_cast<uint8_t>(i + j + frameNumber_ * 4);
+		}
+	}
+
+	std::fill_n(outputData_ + lumaSize, lumaSize / 4, static_cast<uint8_t>(128 + frameNumber_ % 32));
+	std::fill_n(outputData_ + lumaSize * 5 / 4, lumaSize / 4, static_cast<uint8_t>(128 - frameNumber_ % 32));
+
+	// Stamp the frame number, most significant bit first
+	const uint16_t blockWidth = frameWidth_ / STAMP_BITS;
+
+	for (int i = 0; i < STAMP_HEIGHT; i++)
+	{
+		uint8_t* row = outputData_ + i * frameWidth_;
+
+		for (int j = 0; j < STAMP_BITS; j++)
+		{
+			bool bit = (frameNumber_ >> (STAMP_BITS - 1 - j)) & 1;
+
+			std::fill_n(row + j * blockWidth, blockWidth, bit ? STAMP_WHITE : STAMP_BLACK);
+		}
+	}
+
+	if (onFrameGenerated_)
+	{
+		onFrameGenerated_(frameNumber_);
+	}
+
+	frameNumber_++;
+
+	GetOutputPin<0>().SetData(outputData_);
+	GetOutputPin<0>().SetSize(outputSize_);
+}
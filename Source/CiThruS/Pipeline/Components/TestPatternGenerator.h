@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineSource.h"
+#include "Misc/FramePacer.h"
+
+#include <functional>
+
+// Generates a moving YUV 4:2:0 test pattern with the frame number stamped in the top rows of the image
+// so that frames can be identified after lossy encoding and transmission (see TestPatternAnalyzer)
+class CITHRUS_API TestPatternGenerator : public PipelineSource<1>
+{
+public:
+	// Stops after frameCount frames if it's not 0. frameRate 0 generates frames as fast as they are processed.
+	// onFrameGenerated is called with the frame number of each frame right before it's passed onward
+	TestPatternGenerator(
+		const uint16_t& frameWidth, const uint16_t& frameHeight, const uint32_t& frameCount = 0, const float& frameRate = 0.0f,
+		const std::function<void(const uint32_t& frameNumber)>& onFrameGenerated = nullptr);
+	virtual ~TestPatternGenerator();
+
+	virtual void Process() override;
+
+	// The stamp is a row of black and white blocks, one per bit
+	static constexpr uint8_t STAMP_BITS = 16;
+	static constexpr uint8_t STAMP_HEIGHT = 16;
+
+	static constexpr uint8_t STAMP_BLACK = 16;
+	static constexpr uint8_t STAMP_WHITE = 235;
+
+protected:
+	uint8_t* outputData_;
+	uint32_t outputSize_;
+
+	uint16_t frameWidth_;
+	uint16_t frameHeight_;
+
+	uint32_t frameCount_;
+	uint32_t frameNumber_;
+
+	FramePacer pacer_;
+
+	std::function<void(const uint32_t& frameNumber)> onFrameGenerated_;
+};
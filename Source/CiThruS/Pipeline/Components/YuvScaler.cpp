@@ -0,0 +1,147 @@
+#include "YuvScaler.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+
+YuvScaler::YuvScaler(
+	const uint16_t& inputFrameWidth, const uint16_t& inputFrameHeight,
+	const uint16_t& outputFrameWidth, const uint16_t& outputFrameHeight)
+	:
+	outputData_(nullptr), outputSize_(outputFrameWidth * outputFrameHeight * 3 / 2),
+	inputFrameWidth_(inputFrameWidth), inputFrameHeight_(inputFrameHeight),
+	outputFrameWidth_(outputFrameWidth), outputFrameHeight_(outputFrameHeight)
+{
+	if (inputFrameWidth_ % 2 != 0 || inputFrameHeight_ % 2 != 0 || outputFrameWidth_ % 2 != 0 || outputFrameHeight_ % 2 != 0)
+	{
+		throw std::runtime_error("The width and height of YUV 4:2:0 data must be divisible by 2");
+	}
+
+	GetInputPin<0>().Initialize(this, "yuv420");
+	GetOutputPin<0>().Initialize(this, "yuv420");
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+
+	// If the resolution doesn't change the input is passed through as is
+	if (inputFrameWidth_ == outputFrameWidth_ && inputFrameHeight_ == outputFrameHeight_)
+	{
+		return;
+	}
+
+	outputData_ = new uint8_t[outputSize_];
+
+	lumaMap_ = CreateScaleMap(inputFrameWidth_, inputFrameHeight_, outputFrameWidth_, outputFrameHeight_);
+	chromaMap_ = CreateScaleMap(inputFrameWidth_ / 2, inputFrameHeight_ / 2, outputFrameWidth_ / 2, outputFrameHeight_ / 2);
+}
+
+YuvScaler::~YuvScaler()
+{
+	delete[] outputData_;
+	outputData_ = nullptr;
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void YuvScaler::Process()
+{
+	const uint8_t* inputData = GetInputPin<0>().GetData();
+	uint32_t inputSize = GetInputPin<0>().GetSize();
+
+	const uint32_t inputLumaSize = inputFrameWidth_ * inputFrameHeight_;
+
+	if (!inputData || inputSize != inputLumaSize * 3 / 2)
+	{
+		GetOutputPin<0>().SetData(nullptr);
+		GetOutputPin<0>().SetSize(0);
+
+		return;
+	}
+
+	if (!outputData_)
+	{
+		GetOutputPin<0>().SetData(inputData);
+		GetOutputPin<0>().SetSize(inputSize);
+
+		return;
+	}
+
+	const uint32_t outputLumaSize = outputFrameWidth_ * outputFrameHeight_;
+
+	uint8_t* yOutput = outputData_;
+	uint8_t* uOutput = outputData_ + outputLumaSize;
+	uint8_t* vOutput = outputData_ + outputLumaSize * 5 / 4;
+
+	// Write directly into memory lent by the next component if possible so that it doesn't have to copy the image
+	if (GetOutputPin<0>().HasLentPlanes({ outputLumaSize, outputLumaSize / 4, outputLumaSize / 4 }))
+	{
+		const std::vector<OutputPin::LentPlane>& lentPlanes = GetOutputPin<0>().GetLentPlanes();
+
+		yOutput = lentPlanes[0].data;
+		uOutput = lentPlanes[1].data;
+		vOutput = lentPlanes[2].data;
+	}
+
+	// Scale Y
+	ScalePlane(inputData, yOutput, lumaMap_);
+	// Scale U
+	ScalePlane(inputData + inputLumaSize, uOutput, chromaMap_);
+	// Scale V
+	ScalePlane(inputData + inputLumaSize * 5 / 4, vOutput, chromaMap_);
+
+	GetOutputPin<0>().SetData(yOutput);
+	GetOutputPin<0>().SetSize(outputSize_);
+}
+
+YuvScaler::PlaneScaleMap YuvScaler::CreateScaleMap(const uint32_t& inputWidth, const uint32_t& inputHeight, const uint32_t& outputWidth, const uint32_t& outputHeight)
+{
+	PlaneScaleMap map;
+
+	map.inputWidth = inputWidth;
+	map.outputWidth = outputWidth;
+
+	map.columns = CreateScaleTaps(inputWidth, outputWidth);
+	map.rows = CreateScaleTaps(inputHeight, outputHeight);
+
+	return map;
+}
+
+std::vector<YuvScaler::ScaleTap> YuvScaler::CreateScaleTaps(const uint32_t& inputLength, const uint32_t& outputLength)
+{
+	std::vector<ScaleTap> taps(outputLength);
+
+	const float ratio = static_cast<float>(inputLength) / outputLength;
+
+	for (uint32_t i = 0; i < outputLength; i++)
+	{
+		// Align pixel centers so that the image doesn't shift when scaling
+		float position = std::clamp((i + 0.5f) * ratio - 0.5f, 0.0f, static_cast<float>(inputLength - 1));
+		uint32_t first = static_cast<uint32_t>(std::floor(position));
+
+		taps[i].first = first;
+		taps[i].second = std::min(first + 1, inputLength - 1);
+		taps[i].weight = static_cast<uint16_t>(std::lround((position - first) * WEIGHT_ONE));
+	}
+
+	return taps;
+}
+
+void YuvScaler::ScalePlane(const uint8_t* input, uint8_t* output, const PlaneScaleMap& map)
+{
+	for (const ScaleTap& row : map.rows)
+	{
+		const uint8_t* topRow = input + row.first * map.inputWidth;
+		const uint8_t* bottomRow = input + row.second * map.inputWidth;
+
+		for (const ScaleTap& column : map.columns)
+		{
+			uint32_t top    = topRow[column.first]    * (WEIGHT_ONE - column.weight) + topRow[column.second]    * column.weight;
+			uint32_t bottom = bottomRow[column.first] * (WEIGHT_ONE - column.weight) + bottomRow[column.second] * column.weight;
+
+			// Fixed point multiplication with rounding
+			*output = (top * (WEIGHT_ONE - row.weight) + bottom * row.weight + WEIGHT_ONE * WEIGHT_ONE / 2) >> 16;
+			output++;
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineFilter.h"
+
+#include <vector>
+
+// Scales YUV 4:2:0 images to a different resolution using bilinear filtering
+class CITHRUS_API YuvScaler : public PipelineFilter<1, 1>
+{
+public:
+	YuvScaler(
+		const uint16_t& inputFrameWidth, const uint16_t& inputFrameHeight,
+		const uint16_t& outputFrameWidth, const uint16_t& outputFrameHeight);
+	virtual ~YuvScaler();
+
+	virtual void Process() override;
+
+protected:
+	// Two neighboring input samples and the fixed point weight of the second one
+	struct ScaleTap
+	{
+		uint32_t first;
+		uint32_t second;
+		uint16_t weight;
+	};
+
+	// Precalculated sample positions for scaling one plane
+	struct PlaneScaleMap
+	{
+		uint32_t inputWidth;
+		uint32_t outputWidth;
+
+		std::vector<ScaleTap> columns;
+		std::vector<ScaleTap> rows;
+	};
+
+	static const uint16_t WEIGHT_ONE = 256;
+
+	uint8_t* outputData_;
+	uint32_t outputSize_;
+
+	uint16_t inputFrameWidth_;
+	uint16_t inputFrameHeight_;
+	uint16_t outputFrameWidth_;
+	uint16_t outputFrameHeight_;
+
+	PlaneScaleMap lumaMap_;
+	PlaneScaleMap chromaMap_;
+
+	static PlaneScaleMap CreateScaleMap(const uint32_t& inputWidth, const uint32_t& inputHeight, const uint32_t& outputWidth, const uint32_t& outputHeight);
+	static std::vector<ScaleTap> CreateScaleTaps(const uint32_t& inputLength, const uint32_t& outputLength);
+
+	static void ScalePlane(const uint8_t* input, uint8_t* output, const PlaneScaleMap& map);
+};
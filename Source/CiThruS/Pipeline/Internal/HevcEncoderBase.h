@@ -0,0 +1,43 @@
+#pragma once
+
+#include "Optional/Kvazaar.h"
+#include "CoreMinimal.h"
+
+#include <string>
+#include <chrono>
+
+enum HevcEncoderPreset : uint8_t
+{
+	HevcPresetNone,
+	HevcPresetMinimumLatency,
+	HevcPresetLossless
+};
+
+// Encodes YUV 4:2:0 data into HEVC video using Kvazaar
+class HevcEncoderBase
+{
+public:
+	virtual ~HevcEncoderBase();
+
+protected:
+	uint32_t frameWidth_;
+	uint32_t frameHeight_;
+
+	uint8_t* outputData_;
+	uint32_t outputSize_;
+
+	std::chrono::high_resolution_clock::time_point startTime_;
+
+#ifdef CITHRUS_KVAZAAR_AVAILABLE
+	const kvz_api* kvazaarApi_ = kvz_api_get(8);
+	kvz_config* kvazaarConfig_;
+	kvz_encoder* kvazaarEncoder_;
+	kvz_picture* kvazaarTransmitPicture_;
+#endif // CITHRUS_KVAZAAR_AVAILABLE
+
+	HevcEncoderBase(const uint16_t& frameWidth, const uint16_t& frameHeight, const uint8_t& threadCount, const uint8_t& qp, const uint8_t& wpp, const uint8_t& owf, const HevcEncoderPreset& preset, const uint8_t& tileColumns, const uint8_t& tileRows, const bool& regionOfInterest);
+
+	// Encodes one frame into outputData_ and outputSize_, which are set to nullptr and 0 if the encoder didn't output anything.
+	// roiMap contains a delta QP for each block of the frame in raster order (see RoiMapGenerator) and can be nullptr
+	void EncodeInternal(const uint8_t* yuvFrame, const int8_t* roiMap = nullptr, const uint16_t& roiMapWidth = 0, const uint16_t& roiMapHeight = 0);
+};
@@ -38,7 +38,7 @@ public:
 	};
 
 	InputPin()
-		: connectedPin_(nullptr), acceptedFormats_(), acceptAnyFormat_(false), initialized_(false), ownerName_(""), ownerIndex_(-1) { }
+		: connectedPin_(nullptr), acceptedFormats_(), acceptAnyFormat_(false), initialized_(false), forwardsOnly_(false), ownerName_(""), ownerIndex_(-1) { }
 	~InputPin() { }
 
 	inline const uint8_t* GetData() const { return connectedPin_->GetData(); }
@@ -47,6 +47,9 @@ public:
 
 	inline OutputPin& GetConnectedPin() { return *connectedPin_; }
 
+	// Offers memory to the component that produces the data for this pin, see OutputPin::LendPlanes
+	inline bool LendPlanes(const std::vector<OutputPin::LentPlane>& planes) { return connectedPin_->LendPlanes(planes); }
+
 	template<class TOwner>
 	inline void Initialize(const TOwner* owner, const AcceptedFormats& acceptedFormats)
 	{
@@ -75,6 +78,16 @@ public:
 		SetOwner(owner);
 	}
 
+	// Used by scaffolding whose input pins only pass the connected output pin on to the components inside them.
+	// Such pins never read the data themselves, so they don't count as readers of the output pin
+	template<class TOwner>
+	inline void InitializeAsProxy(const TOwner* owner)
+	{
+		Initialize(owner);
+
+		forwardsOnly_ = true;
+	}
+
 	inline void ConnectToOutputPin(OutputPin& outputPin)
 	{
 		if (!initialized_)
@@ -107,7 +120,7 @@ public:
 		}
 
 		connectedPin_ = &outputPin;
-		outputPin.LockConnection();
+		outputPin.LockConnection(!forwardsOnly_);
 	}
 
 protected:
@@ -117,6 +130,7 @@ protected:
 	bool acceptAnyFormat_;
 
 	bool initialized_;
+	bool forwardsOnly_;
 
 	std::string ownerName_;
 	int ownerIndex_;
@@ -0,0 +1,47 @@
+#include "MappedFile.h"
+
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+
+#include <stdexcept>
+
+MappedFile::MappedFile(const std::string& filePath) : handle_(nullptr), region_(nullptr), data_(nullptr), size_(0)
+{
+	handle_ = FPlatformFileManager::Get().GetPlatformFile().OpenMapped(UTF8_TO_TCHAR(filePath.c_str()));
+
+	if (!handle_)
+	{
+		throw std::runtime_error("Failed to open file " + filePath);
+	}
+
+	if (handle_->GetFileSize() == 0)
+	{
+		return;
+	}
+
+	region_ = handle_->MapRegion(0, handle_->GetFileSize());
+
+	if (!region_)
+	{
+		delete handle_;
+		handle_ = nullptr;
+
+		throw std::runtime_error("Failed to map file " + filePath);
+	}
+
+	data_ = region_->GetMappedPtr();
+	size_ = region_->GetMappedSize();
+}
+
+MappedFile::~MappedFile()
+{
+	// The region must be released before the handle
+	delete region_;
+	region_ = nullptr;
+
+	delete handle_;
+	handle_ = nullptr;
+
+	data_ = nullptr;
+	size_ = 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <string>
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Read-only memory mapping of a whole file. The operating system pages the file in as it's read,
+// which avoids copying it through an intermediate buffer
+class MappedFile
+{
+public:
+	MappedFile(const std::string& filePath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	inline const uint8_t* GetData() const { return data_; }
+	inline uint64_t GetSize() const { return size_; }
+
+protected:
+	IMappedFileHandle* handle_;
+	IMappedFileRegion* region_;
+
+	const uint8_t* data_;
+	uint64_t size_;
+};
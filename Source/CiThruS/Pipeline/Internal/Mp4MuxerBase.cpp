@@ -0,0 +1,657 @@
+#include "Mp4MuxerBase.h"
+
+#include <filesystem>
+#include <stdexcept>
+#include <cmath>
+
+namespace
+{
+	// Builds MP4 boxes in big endian byte order
+	class BoxWriter
+	{
+	public:
+		inline void U8(const uint8_t& value) { data_.push_back(value); }
+		inline void U16(const uint16_t& value) { U8(value >> 8); U8(value & 0xFF); }
+		inline void U32(const uint32_t& value) { U16(value >> 16); U16(value & 0xFFFF); }
+		inline void U64(const uint64_t& value) { U32(value >> 32); U32(value & 0xFFFFFFFF); }
+
+		inline void Bytes(const uint8_t* data, const size_t& size) { data_.insert(data_.end(), data, data + size); }
+		inline void Bytes(const std::vector<uint8_t>& data) { Bytes(data.data(), data.size()); }
+		inline void Zeros(const size_t& count) { data_.insert(data_.end(), count, 0); }
+		inline void String(const std::string& value) { Bytes(reinterpret_cast<const uint8_t*>(value.c_str()), value.size() + 1); }
+
+		// Boxes are nested by calling EndBox in the reverse order of BeginBox
+		inline void BeginBox(const char* type)
+		{
+			boxStarts_.push_back(data_.size());
+
+			U32(0);
+			Bytes(reinterpret_cast<const uint8_t*>(type), 4);
+		}
+
+		inline void BeginFullBox(const char* type, const uint8_t& version, const uint32_t& flags)
+		{
+			BeginBox(type);
+			U32((version << 24) | flags);
+		}
+
+		inline void EndBox()
+		{
+			size_t start = boxStarts_.back();
+			uint32_t size = static_cast<uint32_t>(data_.size() - start);
+
+			boxStarts_.pop_back();
+
+			data_[start] = size >> 24;
+			data_[start + 1] = (size >> 16) & 0xFF;
+			data_[start + 2] = (size >> 8) & 0xFF;
+			data_[start + 3] = size & 0xFF;
+		}
+
+		inline void Patch32(const size_t& position, const uint32_t& value)
+		{
+			data_[position] = value >> 24;
+			data_[position + 1] = (value >> 16) & 0xFF;
+			data_[position + 2] = (value >> 8) & 0xFF;
+			data_[position + 3] = value & 0xFF;
+		}
+
+		inline size_t Size() const { return data_.size(); }
+		inline const std::vector<uint8_t>& Data() const { return data_; }
+
+	protected:
+		std::vector<uint8_t> data_;
+		std::vector<size_t> boxStarts_;
+	};
+
+	// Unity matrix used by mvhd and tkhd
+	void WriteMatrix(BoxWriter& writer)
+	{
+		const uint32_t matrix[9] = { 0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000 };
+
+		for (const uint32_t& value : matrix)
+		{
+			writer.U32(value);
+		}
+	}
+
+	// Calls callback with the type, position and size of each NAL unit in Annex B data, excluding start codes
+	template <typename TCallback>
+	void ForEachNalUnit(const uint8_t* data, const uint32_t& size, TCallback callback)
+	{
+		uint32_t start = 0;
+		bool inNalUnit = false;
+
+		for (uint32_t i = 0; i + 2 < size; i++)
+		{
+			if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1)
+			{
+				continue;
+			}
+
+			if (inNalUnit)
+			{
+				// The zero before a four byte start code belongs to the start code, not the NAL unit
+				uint32_t end = (i > start && data[i - 1] == 0) ? i - 1 : i;
+
+				callback((data[start] >> 1) & 0x3F, data + start, end - start);
+			}
+
+			start = i + 3;
+			inNalUnit = true;
+			i += 2;
+		}
+
+		if (inNalUnit && start < size)
+		{
+			callback((data[start] >> 1) & 0x3F, data + start, size - start);
+		}
+	}
+
+	constexpr uint8_t NAL_VPS = 32;
+	constexpr uint8_t NAL_SPS = 33;
+	constexpr uint8_t NAL_PPS = 34;
+
+	// Intra random access point picture types, which can be decoded without earlier pictures
+	inline bool IsIrap(const uint8_t& nalType) { return nalType >= 16 && nalType <= 23; }
+}
+
+Mp4MuxerBase::Mp4MuxerBase(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight, const float& frameRate,
+	const uint32_t& maxFragmentFrames)
+	: fileHandle_(nullptr), fileOffset_(0), frameWidth_(frameWidth), frameHeight_(frameHeight), maxFragmentFrames_(maxFragmentFrames),
+	metadataMimeType_(""), headerWritten_(false), sequenceNumber_(0), video_({ {}, {}, {}, 0 }), metadata_({ {}, {}, {}, 0 })
+{
+	if (frameRate <= 0.0f)
+	{
+		throw std::invalid_argument("Frame rate must be positive");
+	}
+
+	if (maxFragmentFrames_ == 0)
+	{
+		throw std::invalid_argument("Fragments must be able to hold at least one frame");
+	}
+
+	sampleDuration_ = static_cast<uint32_t>(std::round(TIMESCALE / frameRate));
+
+	std::filesystem::path directoryPath = std::filesystem::path(filePath).parent_path();
+
+	if (!directoryPath.empty() && !std::filesystem::exists(directoryPath))
+	{
+		std::filesystem::create_directories(directoryPath);
+	}
+
+	fileHandle_ = fopen(filePath.data(), "wb");
+
+	if (fileHandle_ == nullptr)
+	{
+		throw std::logic_error("Failed to open file");
+	}
+}
+
+Mp4MuxerBase::~Mp4MuxerBase()
+{
+	if (headerWritten_)
+	{
+		WriteFragment();
+		WriteIndex();
+	}
+
+	fclose(fileHandle_);
+
+	fileHandle_ = nullptr;
+}
+
+void Mp4MuxerBase::EnableMetadataTrack(const std::string& mimeType)
+{
+	if (headerWritten_)
+	{
+		throw std::logic_error("Tracks cannot be added after the file has been started");
+	}
+
+	metadataMimeType_ = mimeType;
+}
+
+void Mp4MuxerBase::AddVideoFrame(const uint8_t* data, const uint32_t& size)
+{
+	bool keyframe = false;
+	std::vector<std::vector<uint8_t>> parameterSets;
+
+	ForEachNalUnit(data, size, [&](const uint8_t& type, const uint8_t* nalData, const uint32_t& nalSize)
+		{
+			keyframe |= IsIrap(type);
+
+			if (type == NAL_VPS || type == NAL_SPS || type == NAL_PPS)
+			{
+				parameterSets.push_back(std::vector<uint8_t>(nalData, nalData + nalSize));
+			}
+		});
+
+	// Each encoded frame corresponds to the oldest frame whose metadata hasn't been used yet. If there is none,
+	// an empty sample keeps the metadata of later frames in sync
+	std::vector<uint8_t> frameMetadata;
+
+	if (!pendingMetadata_.empty())
+	{
+		frameMetadata.swap(pendingMetadata_.front());
+		pendingMetadata_.pop_front();
+	}
+
+	if (!headerWritten_)
+	{
+		// The file can only start once the decoder configuration is known
+		if (!keyframe || parameterSets.size() < 3)
+		{
+			return;
+		}
+
+		WriteHeader(parameterSets);
+	}
+
+	if (keyframe || video_.sampleSizes.size() >= maxFragmentFrames_)
+	{
+		WriteFragment();
+	}
+
+	// MP4 samples store each NAL unit with its size in front instead of a start code
+	uint32_t sampleSize = 0;
+
+	ForEachNalUnit(data, size, [&](const uint8_t& type, const uint8_t* nalData, const uint32_t& nalSize)
+		{
+			BoxWriter length;
+
+			length.U32(nalSize);
+
+			video_.data.insert(video_.data.end(), length.Data().begin(), length.Data().end());
+			video_.data.insert(video_.data.end(), nalData, nalData + nalSize);
+
+			sampleSize += 4 + nalSize;
+		});
+
+	video_.sampleSizes.push_back(sampleSize);
+	video_.sampleKeyframes.push_back(keyframe);
+
+	if (!metadataMimeType_.empty())
+	{
+		metadata_.data.insert(metadata_.data.end(), frameMetadata.begin(), frameMetadata.end());
+		metadata_.sampleSizes.push_back(static_cast<uint32_t>(frameMetadata.size()));
+		metadata_.sampleKeyframes.push_back(true);
+	}
+}
+
+void Mp4MuxerBase::AddMetadata(const uint8_t* data, const uint32_t& size)
+{
+	if (metadataMimeType_.empty())
+	{
+		return;
+	}
+
+	// The encoder delay is a few frames, so if this many frames are waiting the video isn't coming at all
+	if (pendingMetadata_.size() >= maxFragmentFrames_)
+	{
+		pendingMetadata_.pop_front();
+	}
+
+	pendingMetadata_.push_back(std::vector<uint8_t>(data, data + size));
+}
+
+void Mp4MuxerBase::WriteHeader(const std::vector<std::vector<uint8_t>>& parameterSets)
+{
+	BoxWriter writer;
+
+	writer.BeginBox("ftyp");
+	writer.Bytes(reinterpret_cast<const uint8_t*>("iso6"), 4);
+	writer.U32(0);
+	writer.Bytes(reinterpret_cast<const uint8_t*>("iso6isomhev1"), 12);
+	writer.EndBox();
+
+	writer.BeginBox("moov");
+
+	writer.BeginFullBox("mvhd", 0, 0);
+	writer.U32(0); // Creation time
+	writer.U32(0); // Modification time
+	writer.U32(TIMESCALE);
+	writer.U32(0); // Duration is unknown because of fragmentation
+	writer.U32(0x00010000); // Playback rate 1.0
+	writer.U16(0x0100); // Volume 1.0
+	writer.Zeros(10);
+	WriteMatrix(writer);
+	writer.Zeros(24);
+	writer.U32(metadataMimeType_.empty() ? VIDEO_TRACK_ID + 1 : METADATA_TRACK_ID + 1);
+	writer.EndBox();
+
+	// Video track
+	BoxWriter videoEntry;
+
+	videoEntry.BeginBox("hev1");
+	videoEntry.Zeros(6);
+	videoEntry.U16(1); // Data reference index
+	videoEntry.Zeros(16);
+	videoEntry.U16(frameWidth_);
+	videoEntry.U16(frameHeight_);
+	videoEntry.U32(0x00480000); // 72 DPI
+	videoEntry.U32(0x00480000);
+	videoEntry.U32(0);
+	videoEntry.U16(1); // Frame count
+	videoEntry.Zeros(32); // Compressor name
+	videoEntry.U16(0x0018); // Depth
+	videoEntry.U16(0xFFFF);
+	videoEntry.BeginBox("hvcC");
+	videoEntry.Bytes(CreateDecoderConfiguration(parameterSets));
+	videoEntry.EndBox();
+	videoEntry.EndBox();
+
+	writer.Bytes(CreateTrack(VIDEO_TRACK_ID, { 'v', 'i', 'd', 'e' }, videoEntry.Data(), frameWidth_, frameHeight_));
+
+	// Metadata track
+	if (!metadataMimeType_.empty())
+	{
+		BoxWriter metadataEntry;
+
+		metadataEntry.BeginBox("mett");
+		metadataEntry.Zeros(6);
+		metadataEntry.U16(1); // Data reference index
+		metadataEntry.String(""); // Content encoding
+		metadataEntry.String(metadataMimeType_);
+		metadataEntry.EndBox();
+
+		writer.Bytes(CreateTrack(METADATA_TRACK_ID, { 'm', 'e', 't', 'a' }, metadataEntry.Data(), 0, 0));
+	}
+
+	writer.BeginBox("mvex");
+
+	for (uint32_t trackId = VIDEO_TRACK_ID; trackId <= (metadataMimeType_.empty() ? VIDEO_TRACK_ID : METADATA_TRACK_ID); trackId++)
+	{
+		writer.BeginFullBox("trex", 0, 0);
+		writer.U32(trackId);
+		writer.U32(1); // Sample description index
+		writer.U32(0);
+		writer.U32(0);
+		writer.U32(0);
+		writer.EndBox();
+	}
+
+	writer.EndBox();
+
+	writer.EndBox();
+
+	Write(writer.Data());
+
+	headerWritten_ = true;
+}
+
+void Mp4MuxerBase::WriteFragment()
+{
+	if (video_.sampleSizes.empty())
+	{
+		return;
+	}
+
+	sequenceNumber_++;
+
+	const uint64_t moofOffset = fileOffset_;
+
+	if (video_.sampleKeyframes[0])
+	{
+		keyframeIndex_.push_back({ video_.firstSample * sampleDuration_, moofOffset });
+	}
+
+	BoxWriter writer;
+	std::vector<size_t> dataOffsetPositions;
+
+	writer.BeginBox("moof");
+
+	writer.BeginFullBox("mfhd", 0, 0);
+	writer.U32(sequenceNumber_);
+	writer.EndBox();
+
+	for (Fragment* fragment : { &video_, &metadata_ })
+	{
+		if (fragment->sampleSizes.empty())
+		{
+			continue;
+		}
+
+		writer.BeginBox("traf");
+
+		// Sample data offsets are relative to the start of the moof box
+		writer.BeginFullBox("tfhd", 0, 0x020000);
+		writer.U32(fragment == &video_ ? VIDEO_TRACK_ID : METADATA_TRACK_ID);
+		writer.EndBox();
+
+		writer.BeginFullBox("tfdt", 1, 0);
+		writer.U64(fragment->firstSample * sampleDuration_);
+		writer.EndBox();
+
+		// Data offset, sample duration, sample size and sample flags are present
+		writer.BeginFullBox("trun", 0, 0x000001 | 0x000100 | 0x000200 | 0x000400);
+		writer.U32(static_cast<uint32_t>(fragment->sampleSizes.size()));
+
+		dataOffsetPositions.push_back(writer.Size());
+		writer.U32(0);
+
+		for (size_t i = 0; i < fragment->sampleSizes.size(); i++)
+		{
+			writer.U32(sampleDuration_);
+			writer.U32(fragment->sampleSizes[i]);
+			// Keyframes don't depend on other frames, other frames do and aren't sync samples
+			writer.U32(fragment->sampleKeyframes[i] ? 0x02000000 : 0x01010000);
+		}
+
+		writer.EndBox();
+
+		writer.EndBox();
+	}
+
+	writer.EndBox();
+
+	// The sample data of all tracks follows in one mdat box, in the same order as the track fragments
+	size_t dataOffset = writer.Size() + 8;
+	size_t trackIndex = 0;
+
+	for (Fragment* fragment : { &video_, &metadata_ })
+	{
+		if (fragment->sampleSizes.empty())
+		{
+			continue;
+		}
+
+		writer.Patch32(dataOffsetPositions[trackIndex], static_cast<uint32_t>(dataOffset));
+
+		dataOffset += fragment->data.size();
+		trackIndex++;
+	}
+
+	writer.U32(static_cast<uint32_t>(8 + video_.data.size() + metadata_.data.size()));
+	writer.Bytes(reinterpret_cast<const uint8_t*>("mdat"), 4);
+
+	Write(writer.Data());
+	Write(video_.data);
+	Write(metadata_.data);
+
+	for (Fragment* fragment : { &video_, &metadata_ })
+	{
+		fragment->firstSample += fragment->sampleSizes.size();
+
+		fragment->data.clear();
+		fragment->sampleSizes.clear();
+		fragment->sampleKeyframes.clear();
+	}
+}
+
+void Mp4MuxerBase::WriteIndex()
+{
+	BoxWriter writer;
+
+	writer.BeginBox("mfra");
+
+	writer.BeginFullBox("tfra", 1, 0);
+	writer.U32(VIDEO_TRACK_ID);
+	writer.U32(0); // Traf, trun and sample numbers are one byte each
+	writer.U32(static_cast<uint32_t>(keyframeIndex_.size()));
+
+	for (const IndexEntry& entry : keyframeIndex_)
+	{
+		writer.U64(entry.time);
+		writer.U64(entry.moofOffset);
+		writer.U8(1); // Traf number
+		writer.U8(1); // Trun number
+		writer.U8(1); // Sample number
+	}
+
+	writer.EndBox();
+
+	writer.BeginFullBox("mfro", 0, 0);
+	writer.U32(static_cast<uint32_t>(writer.Size() + 4));
+	writer.EndBox();
+
+	writer.EndBox();
+
+	Write(writer.Data());
+}
+
+void Mp4MuxerBase::Write(const std::vector<uint8_t>& data)
+{
+	fwrite(data.data(), 1, data.size(), fileHandle_);
+
+	fileOffset_ += data.size();
+}
+
+std::vector<uint8_t> Mp4MuxerBase::CreateDecoderConfiguration(const std::vector<std::vector<uint8_t>>& parameterSets)
+{
+	const std::vector<uint8_t>* sps = nullptr;
+
+	for (const std::vector<uint8_t>& parameterSet : parameterSets)
+	{
+		if (((parameterSet[0] >> 1) & 0x3F) == NAL_SPS)
+		{
+			sps = &parameterSet;
+		}
+	}
+
+	if (!sps)
+	{
+		throw std::runtime_error("HEVC sequence parameter set missing");
+	}
+
+	// Remove emulation prevention bytes from the beginning of the SPS, which contains the
+	// general profile, tier and level: the 2 byte NAL header, 1 byte of other fields and 12 bytes of profile
+	std::vector<uint8_t> rbsp;
+
+	for (size_t i = 0; i < sps->size() && rbsp.size() < 15; i++)
+	{
+		if (i >= 2 && (*sps)[i] == 3 && (*sps)[i - 1] == 0 && (*sps)[i - 2] == 0)
+		{
+			continue;
+		}
+
+		rbsp.push_back((*sps)[i]);
+	}
+
+	if (rbsp.size() < 15)
+	{
+		throw std::runtime_error("Invalid HEVC sequence parameter set");
+	}
+
+	const uint8_t maxSubLayersMinus1 = (rbsp[2] >> 1) & 0x07;
+	const uint8_t temporalIdNesting = rbsp[2] & 0x01;
+
+	BoxWriter writer;
+
+	writer.U8(1); // Configuration version
+	writer.Bytes(rbsp.data() + 3, 12); // Profile space, tier, profile, compatibility flags, constraint flags and level
+	writer.U16(0xF000); // No spatial segmentation
+	writer.U8(0xFC); // Unknown parallelism type
+	writer.U8(0xFD); // Chroma format 4:2:0
+	writer.U8(0xF8); // 8 bit luma
+	writer.U8(0xF8); // 8 bit chroma
+	writer.U16(0); // Unknown average frame rate
+	writer.U8(((maxSubLayersMinus1 + 1) << 3) | (temporalIdNesting << 2) | 0x03); // NAL unit lengths are 4 bytes
+	writer.U8(3);
+
+	for (const uint8_t& type : { NAL_VPS, NAL_SPS, NAL_PPS })
+	{
+		uint16_t count = 0;
+
+		for (const std::vector<uint8_t>& parameterSet : parameterSets)
+		{
+			count += ((parameterSet[0] >> 1) & 0x3F) == type;
+		}
+
+		// The parameter sets are also repeated in the stream (hev1), so the arrays aren't complete
+		writer.U8(type);
+		writer.U16(count);
+
+		for (const std::vector<uint8_t>& parameterSet : parameterSets)
+		{
+			if (((parameterSet[0] >> 1) & 0x3F) == type)
+			{
+				writer.U16(static_cast<uint16_t>(parameterSet.size()));
+				writer.Bytes(parameterSet);
+			}
+		}
+	}
+
+	return writer.Data();
+}
+
+std::vector<uint8_t> Mp4MuxerBase::CreateTrack(const uint32_t& trackId, const std::vector<uint8_t>& handler, const std::vector<uint8_t>& sampleEntry, const uint16_t& width, const uint16_t& height)
+{
+	const bool video = handler[0] == 'v';
+
+	BoxWriter writer;
+
+	writer.BeginBox("trak");
+
+	// Enabled and in movie
+	writer.BeginFullBox("tkhd", 0, 0x000003);
+	writer.U32(0); // Creation time
+	writer.U32(0); // Modification time
+	writer.U32(trackId);
+	writer.U32(0);
+	writer.U32(0); // Duration
+	writer.Zeros(8);
+	writer.U16(0); // Layer
+	writer.U16(0); // Alternate group
+	writer.U16(0); // Volume
+	writer.U16(0);
+	WriteMatrix(writer);
+	writer.U32(width << 16);
+	writer.U32(height << 16);
+	writer.EndBox();
+
+	writer.BeginBox("mdia");
+
+	writer.BeginFullBox("mdhd", 0, 0);
+	writer.U32(0); // Creation time
+	writer.U32(0); // Modification time
+	writer.U32(TIMESCALE);
+	writer.U32(0); // Duration
+	writer.U16(0x55C4); // Language "und"
+	writer.U16(0);
+	writer.EndBox();
+
+	writer.BeginFullBox("hdlr", 0, 0);
+	writer.U32(0);
+	writer.Bytes(handler);
+	writer.Zeros(12);
+	writer.String(video ? "CiThruS video" : "CiThruS metadata");
+	writer.EndBox();
+
+	writer.BeginBox("minf");
+
+	if (video)
+	{
+		writer.BeginFullBox("vmhd", 0, 1);
+		writer.Zeros(8);
+		writer.EndBox();
+	}
+	else
+	{
+		writer.BeginFullBox("nmhd", 0, 0);
+		writer.EndBox();
+	}
+
+	writer.BeginBox("dinf");
+	writer.BeginFullBox("dref", 0, 0);
+	writer.U32(1);
+	// The data is in the same file
+	writer.BeginFullBox("url ", 0, 1);
+	writer.EndBox();
+	writer.EndBox();
+	writer.EndBox();
+
+	// Sample tables are empty because the samples are described in the fragments
+	writer.BeginBox("stbl");
+
+	writer.BeginFullBox("stsd", 0, 0);
+	writer.U32(1);
+	writer.Bytes(sampleEntry);
+	writer.EndBox();
+
+	writer.BeginFullBox("stts", 0, 0);
+	writer.U32(0);
+	writer.EndBox();
+
+	writer.BeginFullBox("stsc", 0, 0);
+	writer.U32(0);
+	writer.EndBox();
+
+	writer.BeginFullBox("stsz", 0, 0);
+	writer.U32(0);
+	writer.U32(0);
+	writer.EndBox();
+
+	writer.BeginFullBox("stco", 0, 0);
+	writer.U32(0);
+	writer.EndBox();
+
+	writer.EndBox();
+
+	writer.EndBox();
+
+	writer.EndBox();
+
+	writer.EndBox();
+
+	return writer.Data();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <stdio.h>
+
+// Writes HEVC video into a fragmented MP4 file. Each fragment starts at a keyframe whenever possible,
+// and an index of the fragments that start at keyframes is written at the end of the file (mfra), so
+// players and analysis tools can seek without reading the whole file. Optionally stores per-frame
+// metadata in a second, timed metadata track
+class Mp4MuxerBase
+{
+public:
+	virtual ~Mp4MuxerBase();
+
+protected:
+	// maxFragmentFrames limits how many frames are buffered in memory if keyframes are rare
+	Mp4MuxerBase(const std::string& filePath, const uint16_t& frameWidth, const uint16_t& frameHeight, const float& frameRate, const uint32_t& maxFragmentFrames);
+
+	// Adds a metadata track with the given MIME type. Must be called before the first video frame
+	void EnableMetadataTrack(const std::string& mimeType);
+
+	// Takes one access unit of Annex B HEVC data, as output by HevcEncoder. The oldest queued metadata is muxed
+	// along with it
+	void AddVideoFrame(const uint8_t* data, const uint32_t& size);
+	// Queues the metadata of the next frame given to the encoder. The encoder only outputs frames after a delay,
+	// so the metadata has to wait until the encoded frame reaches AddVideoFrame
+	void AddMetadata(const uint8_t* data, const uint32_t& size);
+
+private:
+	struct Fragment
+	{
+		std::vector<uint8_t> data;
+		std::vector<uint32_t> sampleSizes;
+		std::vector<bool> sampleKeyframes;
+
+		uint64_t firstSample;
+	};
+
+	struct IndexEntry
+	{
+		uint64_t time;
+		uint64_t moofOffset;
+	};
+
+	static constexpr uint32_t TIMESCALE = 90000;
+
+	static constexpr uint32_t VIDEO_TRACK_ID = 1;
+	static constexpr uint32_t METADATA_TRACK_ID = 2;
+
+	FILE* fileHandle_;
+	uint64_t fileOffset_;
+
+	uint16_t frameWidth_;
+	uint16_t frameHeight_;
+	uint32_t sampleDuration_;
+	uint32_t maxFragmentFrames_;
+
+	std::string metadataMimeType_;
+
+	bool headerWritten_;
+	uint32_t sequenceNumber_;
+
+	Fragment video_;
+	Fragment metadata_;
+
+	std::deque<std::vector<uint8_t>> pendingMetadata_;
+
+	std::vector<IndexEntry> keyframeIndex_;
+
+	void WriteHeader(const std::vector<std::vector<uint8_t>>& parameterSets);
+	void WriteFragment();
+	void WriteIndex();
+
+	void Write(const std::vector<uint8_t>& data);
+
+	static std::vector<uint8_t> CreateDecoderConfiguration(const std::vector<std::vector<uint8_t>>& parameterSets);
+	static std::vector<uint8_t> CreateTrack(const uint32_t& trackId, const std::vector<uint8_t>& handler, const std::vector<uint8_t>& sampleEntry, const uint16_t& width, const uint16_t& height);
+};
@@ -1,15 +1,24 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <stdexcept>
+#include <initializer_list>
 
 // Represents one output data stream of a pipeline component.
 // Must be connected to an InputPin to pass data onward
 class OutputPin
 {
 public:
+	// A region of memory owned by a downstream component
+	struct LentPlane
+	{
+		uint8_t* data;
+		uint32_t size;
+	};
+
 	OutputPin()
-		: data_(nullptr), dataSize_(0), dataFormat_("error"), initialized_(false), connected_(false), ownerName_(""), ownerIndex_(-1) { }
+		: data_(nullptr), dataSize_(0), dataFormat_("error"), initialized_(false), connected_(false), connectionCount_(0), forwardedPin_(nullptr), ownerName_(""), ownerIndex_(-1) { }
 	~OutputPin() { }
 
 	inline const uint8_t* GetData() const { return data_; }
@@ -19,6 +28,58 @@ public:
 	inline void SetData(const uint8_t* data) { data_ = data; }
 	inline void SetSize(const uint32_t& dataSize) { dataSize_ = dataSize; }
 
+	// Lets the only downstream component reading this pin lend memory to the owner of this pin,
+	// which can then write its output planes there directly instead of into its own buffer.
+	// The owner signals that it has done so by setting the output data to the first lent plane.
+	// Returns false if the planes could not be lent, in which case nothing changes
+	inline bool LendPlanes(const std::vector<LentPlane>& planes)
+	{
+		// The output data is not contiguous when written into lent planes, so other readers would get garbage.
+		// Scaffolding pins that only pass the connection on aren't counted, see InputPin::InitializeAsProxy
+		if (!lentPlanes_.empty() || connectionCount_ > 1)
+		{
+			return false;
+		}
+
+		if (forwardedPin_ && !forwardedPin_->LendPlanes(planes))
+		{
+			return false;
+		}
+
+		lentPlanes_ = planes;
+
+		return true;
+	}
+
+	// Returns true if the planes lent to this pin have exactly the given sizes
+	inline bool HasLentPlanes(const std::initializer_list<uint32_t>& planeSizes) const
+	{
+		if (lentPlanes_.size() != planeSizes.size())
+		{
+			return false;
+		}
+
+		int i = 0;
+
+		for (const uint32_t& planeSize : planeSizes)
+		{
+			if (lentPlanes_[i].size != planeSize)
+			{
+				return false;
+			}
+
+			i++;
+		}
+
+		return true;
+	}
+
+	inline const std::vector<LentPlane>& GetLentPlanes() const { return lentPlanes_; }
+
+	// Used by scaffolding whose output pins only mirror the output pins of the components inside
+	// them so that lent planes reach the component that actually produces the data
+	inline void ForwardLentPlanesTo(OutputPin& pin) { forwardedPin_ = &pin; }
+
 	template<class TOwner>
 	inline void Initialize(const TOwner* owner, const std::string& format)
 	{
@@ -55,6 +116,10 @@ protected:
 
 	bool initialized_;
 	bool connected_;
+	uint32_t connectionCount_;
+
+	std::vector<LentPlane> lentPlanes_;
+	OutputPin* forwardedPin_;
 
 	std::string ownerName_;
 	int ownerIndex_;
@@ -64,7 +129,7 @@ protected:
 		ownerIndex_ = index;
 	}
 
-	inline void LockConnection()
+	inline void LockConnection(const bool& reader)
 	{
 		if (!initialized_)
 		{
@@ -72,6 +137,27 @@ protected:
 		}
 
 		connected_ = true;
+
+		if (!reader)
+		{
+			return;
+		}
+
+		// Another reader needs the output as contiguous data, so the owner goes back to writing into its own buffer
+		// and the component that lent the planes has to copy the data like it would without lending
+		RevokeLentPlanes();
+
+		connectionCount_++;
+	}
+
+	inline void RevokeLentPlanes()
+	{
+		lentPlanes_.clear();
+
+		if (forwardedPin_)
+		{
+			forwardedPin_->RevokeLentPlanes();
+		}
 	}
 
 	inline std::string GetDescriptor() const
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+
+// Layout of the raw frame container files written by RawFrameRecorder. All values are little endian.
+//
+// The file starts with a FileHeader. Each frame follows as a FrameHeader and compressedSize bytes of
+// frame data. After the last frame comes an array of frameCount IndexEntries and finally an IndexTrailer
+// at the very end of the file. If the recording was interrupted, the index is missing but the frames
+// can still be recovered by walking the frame headers from the start of the file
+namespace RawFrameContainer
+{
+	constexpr uint32_t FILE_MAGIC = 0x57525443; // "CTRW"
+	constexpr uint32_t FRAME_MAGIC = 0x46525443; // "CTRF"
+	constexpr uint32_t INDEX_MAGIC = 0x49525443; // "CTRI"
+	constexpr uint32_t VERSION = 2;
+
+	constexpr uint32_t FORMAT_LENGTH = 32;
+
+	enum Compression : uint32_t
+	{
+		CompressionNone,
+		CompressionLz4,
+		CompressionZstd
+	};
+
+#pragma pack(push, 1)
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t compression;
+
+		// Pipeline data format of the frames, for example "rgba", null terminated
+		char format[FORMAT_LENGTH];
+
+		// Size of the frames in pixels, 0 if unknown. The rows of each plane are tightly packed in the layout
+		// of the format, e.g. 4 * width bytes per row for rgba and width bytes per luma row for yuv420
+		uint16_t width;
+		uint16_t height;
+	};
+
+	struct FrameHeader
+	{
+		uint32_t magic;
+		uint32_t compressedSize;
+		uint32_t uncompressedSize;
+
+		// Frames that were dropped during recording leave gaps in the frame numbers
+		uint64_t frameNumber;
+
+		// std::chrono::steady_clock nanoseconds at the time the frame was received
+		int64_t timestamp;
+	};
+
+	struct IndexEntry
+	{
+		// Offset of the FrameHeader from the start of the file
+		uint64_t offset;
+		uint32_t compressedSize;
+		uint32_t uncompressedSize;
+		uint64_t frameNumber;
+		int64_t timestamp;
+	};
+
+	struct IndexTrailer
+	{
+		uint64_t indexOffset;
+		uint64_t frameCount;
+		uint32_t magic;
+	};
+#pragma pack(pop)
+}
@@ -0,0 +1,149 @@
+#include "ReplaySourceBase.h"
+
+#include <stdexcept>
+
+ReplaySourceBase::ReplaySourceBase(const float& frameRate, const bool& loop, const uint8_t& prefetchCount)
+	: loop_(loop), pacer_(frameRate), frames_(prefetchCount + 1), readyFrames_(prefetchCount + 1), freeFrames_(prefetchCount + 1),
+	readyCount_(0), freeCount_(prefetchCount + 1), currentFrame_(nullptr), finished_(false), stopPrefetching_(false)
+{
+	if (prefetchCount == 0)
+	{
+		throw std::invalid_argument("At least one frame must be prefetched");
+	}
+
+	// One extra frame is being output by the source while the rest are prefetched
+	for (Frame& frame : frames_)
+	{
+		frame.endOfStream = false;
+		freeFrames_.TryPush(&frame);
+	}
+}
+
+ReplaySourceBase::~ReplaySourceBase()
+{
+	StopPrefetching();
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+}
+
+void ReplaySourceBase::StartPrefetching()
+{
+	prefetchThread_ = std::thread(&ReplaySourceBase::PrefetchFramesAsync, this);
+}
+
+void ReplaySourceBase::StopPrefetching()
+{
+	if (!prefetchThread_.joinable())
+	{
+		return;
+	}
+
+	stopPrefetching_ = true;
+
+	// Wake up the prefetch thread in case it's waiting for a free frame
+	freeCount_.release();
+
+	prefetchThread_.join();
+}
+
+void ReplaySourceBase::Process()
+{
+	// The previous frame has been processed by now, so it can be reused
+	if (currentFrame_)
+	{
+		freeFrames_.TryPush(currentFrame_);
+		freeCount_.release();
+
+		currentFrame_ = nullptr;
+	}
+
+	GetOutputPin<0>().SetData(nullptr);
+	GetOutputPin<0>().SetSize(0);
+
+	if (finished_)
+	{
+		return;
+	}
+
+	readyCount_.acquire();
+
+	Frame* frame;
+	readyFrames_.TryPop(frame);
+
+	if (frame->endOfStream)
+	{
+		finished_ = true;
+
+		if (!prefetchError_.empty())
+		{
+			throw std::runtime_error(prefetchError_);
+		}
+
+		return;
+	}
+
+	pacer_.WaitForNextFrame();
+
+	currentFrame_ = frame;
+
+	GetOutputPin<0>().SetData(frame->data.data());
+	GetOutputPin<0>().SetSize(static_cast<uint32_t>(frame->data.size()));
+}
+
+void ReplaySourceBase::PrefetchFramesAsync()
+{
+	const uint64_t frameCount = GetFrameCount();
+
+	uint64_t index = 0;
+
+	while (true)
+	{
+		freeCount_.acquire();
+
+		if (stopPrefetching_)
+		{
+			return;
+		}
+
+		Frame* frame;
+		freeFrames_.TryPop(frame);
+
+		frame->endOfStream = false;
+
+		try
+		{
+			// Skip frames that can't be read, but stop if none of them can
+			uint64_t attempts = 0;
+			bool success = false;
+
+			while (!success && index < frameCount && attempts < frameCount)
+			{
+				success = ReadFrame(index, frame->data);
+
+				index++;
+				attempts++;
+
+				if (loop_ && index == frameCount)
+				{
+					index = 0;
+				}
+			}
+
+			frame->endOfStream = !success;
+		}
+		catch (const std::exception& exception)
+		{
+			prefetchError_ = exception.what();
+			frame->endOfStream = true;
+		}
+
+		readyFrames_.TryPush(frame);
+		readyCount_.release();
+
+		if (frame->endOfStream)
+		{
+			return;
+		}
+	}
+}
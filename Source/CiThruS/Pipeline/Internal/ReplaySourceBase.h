@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineSource.h"
+#include "Misc/SpscRingBuffer.h"
+#include "Misc/FramePacer.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <semaphore>
+
+// Base class for sources that play back recorded frames. Frames are read and decoded ahead of time on a
+// background thread so that reading doesn't slow down the pipeline. Outputs nothing once all frames have
+// been played unless looping. Derived classes must initialize the output pin, call StartPrefetching at
+// the end of their constructor and StopPrefetching at the start of their destructor
+class ReplaySourceBase : public PipelineSource<1>
+{
+public:
+	virtual ~ReplaySourceBase();
+
+	virtual void Process() override;
+
+protected:
+	// frameRate 0 outputs frames as fast as they are processed. prefetchCount is the number of frames read ahead
+	ReplaySourceBase(const float& frameRate, const bool& loop, const uint8_t& prefetchCount);
+
+	void StartPrefetching();
+	void StopPrefetching();
+
+	virtual uint64_t GetFrameCount() const = 0;
+
+	// Called on the prefetch thread. Returns false if the frame should be skipped
+	virtual bool ReadFrame(const uint64_t& index, std::vector<uint8_t>& frame) = 0;
+
+private:
+	struct Frame
+	{
+		std::vector<uint8_t> data;
+		bool endOfStream;
+	};
+
+	bool loop_;
+
+	FramePacer pacer_;
+
+	std::vector<Frame> frames_;
+
+	// Frames go from the prefetch thread to the pipeline through readyFrames_ and back through freeFrames_
+	SpscRingBuffer<Frame*> readyFrames_;
+	SpscRingBuffer<Frame*> freeFrames_;
+	std::counting_semaphore<> readyCount_;
+	std::counting_semaphore<> freeCount_;
+
+	Frame* currentFrame_;
+	bool finished_;
+
+	std::thread prefetchThread_;
+	std::atomic<bool> stopPrefetching_;
+
+	// Errors on the prefetch thread are rethrown on the pipeline thread
+	std::string prefetchError_;
+
+	void PrefetchFramesAsync();
+};
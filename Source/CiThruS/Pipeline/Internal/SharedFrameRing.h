@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <atomic>
+
+// Memory layout of the named shared memory segment used by SharedMemorySink and SharedMemorySource.
+// The segment starts with a SharedFrameRingHeader, followed by slotCount SharedFrameSlots and then
+// slotCount data areas of slotSize bytes each. Other programs can read the segment by following this layout
+namespace SharedFrameRing
+{
+	constexpr uint32_t MAGIC = 0x46535443; // "CTSF" in little endian
+	constexpr uint32_t VERSION = 2;
+
+	constexpr uint32_t FORMAT_LENGTH = 32;
+	constexpr uint32_t ALIGNMENT = 64;
+
+	struct Header
+	{
+		// Written last by the sink so that readers can tell when the rest of the header is valid
+		std::atomic<uint32_t> magic;
+		uint32_t version;
+
+		uint32_t slotCount;
+		uint32_t slotSize;
+
+		// Pipeline data format of the frames, for example "yuv420", null terminated
+		char format[FORMAT_LENGTH];
+
+		// Frame size in pixels, or 0 if the frames are not images. stride is the number of bytes between
+		// the starts of consecutive rows in the first plane. Rows are tightly packed and further planes,
+		// such as the chroma planes of yuv420, follow the first one in the usual layout of the format
+		uint32_t width;
+		uint32_t height;
+		uint32_t stride;
+
+		// Sequence number of the newest complete frame. Frame n is in slot n % slotCount and
+		// the first frame is 1, so 0 means that no frames have been written yet
+		alignas(ALIGNMENT) std::atomic<uint64_t> latestSequence;
+	};
+
+	struct Slot
+	{
+		// Sequence number of the frame in this slot, or 0 while the slot is being written
+		alignas(ALIGNMENT) std::atomic<uint64_t> sequence;
+
+		uint32_t size;
+
+		// std::chrono::steady_clock nanoseconds at the time the frame was written
+		int64_t timestamp;
+	};
+
+	static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared memory synchronization requires lock-free atomics");
+
+	inline uint32_t GetAlignedSlotSize(const uint32_t& slotSize)
+	{
+		return (slotSize + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	}
+
+	inline uint64_t GetSegmentSize(const uint32_t& slotCount, const uint32_t& slotSize)
+	{
+		return sizeof(Header) + static_cast<uint64_t>(slotCount) * (sizeof(Slot) + GetAlignedSlotSize(slotSize));
+	}
+
+	inline Slot* GetSlot(uint8_t* segment, const uint32_t& index)
+	{
+		return reinterpret_cast<Slot*>(segment + sizeof(Header)) + index;
+	}
+
+	inline uint8_t* GetSlotData(uint8_t* segment, const uint32_t& index)
+	{
+		const Header* header = reinterpret_cast<const Header*>(segment);
+
+		return segment + sizeof(Header) + static_cast<uint64_t>(header->slotCount) * sizeof(Slot)
+			+ static_cast<uint64_t>(index) * GetAlignedSlotSize(header->slotSize);
+	}
+}
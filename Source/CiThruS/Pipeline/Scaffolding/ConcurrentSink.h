@@ -0,0 +1,165 @@
+#pragma once
+
+#include "Pipeline/Internal/PipelineSink.h"
+#include "Pipeline/Internal/ProxySinkBase.h"
+#include "Misc/TemplateUtility.h"
+
+#include <vector>
+#include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+// Scaffolding for feeding the same input data to multiple sinks which are processed
+// simultaneously on their own threads. Unlike with DuplicatorFilter and ParallelSink,
+// the number of sinks can be decided at runtime
+template <uint8_t NInputs>
+class ConcurrentSink : public ProxySinkBase<NInputs>
+{
+	// Template implementation must be in the header file
+
+public:
+	ConcurrentSink(const std::vector<PipelineSink<NInputs>*>& sinks)
+		: stopping_(false), generation_(0), pendingWorkers_(0), workerException_(nullptr)
+	{
+		if (sinks.empty())
+		{
+			throw std::invalid_argument("ConcurrentSink needs at least one sink");
+		}
+
+		for (PipelineSink<NInputs>* sink : sinks)
+		{
+			if (sink == nullptr)
+			{
+				throw std::invalid_argument("Sink cannot be nullptr");
+			}
+
+			ProxyBase::components_.push_back(sink);
+		}
+
+		// Initialize input pins
+		TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
+		{
+			this->template GetInputPin<i>().InitializeAsProxy(this);
+		});
+
+		ProxySinkBase<NInputs>::onInputPinsConnected_ = [this, sinks]()
+			{
+				// Every sink reads the same data, so all of them are connected to the same pins
+				for (PipelineSink<NInputs>* sink : sinks)
+				{
+					TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
+					{
+						sink->template GetInputPin<i>().ConnectToOutputPin(this->template GetInputPin<i>().GetConnectedPin());
+					});
+
+					sink->OnInputPinsConnected();
+				}
+			};
+
+		for (size_t i = 0; i < sinks.size(); i++)
+		{
+			workers_.push_back(std::thread(&ConcurrentSink::RunWorker, this, i));
+		}
+	}
+
+	virtual ~ConcurrentSink()
+	{
+		{
+			std::lock_guard<std::mutex> lock(workerMutex_);
+
+			stopping_ = true;
+		}
+
+		startCv_.notify_all();
+
+		for (std::thread& worker : workers_)
+		{
+			worker.join();
+		}
+	}
+
+	virtual void Process() override
+	{
+		std::unique_lock<std::mutex> lock(workerMutex_);
+
+		pendingWorkers_ = workers_.size();
+		generation_++;
+
+		startCv_.notify_all();
+
+		// The input data must stay valid until every sink has processed it
+		doneCv_.wait(lock, [this]() { return pendingWorkers_ == 0; });
+
+		if (workerException_)
+		{
+			std::exception_ptr exception = workerException_;
+			workerException_ = nullptr;
+
+			std::rethrow_exception(exception);
+		}
+	}
+
+protected:
+	std::vector<std::thread> workers_;
+
+	std::mutex workerMutex_;
+	std::condition_variable startCv_;
+	std::condition_variable doneCv_;
+
+	bool stopping_;
+	uint64_t generation_;
+	size_t pendingWorkers_;
+
+	// Exceptions are passed to the pipeline thread so that they can be handled like any other pipeline error
+	std::exception_ptr workerException_;
+
+	void RunWorker(const size_t& index)
+	{
+		uint64_t processedGeneration = 0;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(workerMutex_);
+
+				startCv_.wait(lock, [&, this]() { return stopping_ || generation_ != processedGeneration; });
+
+				if (stopping_)
+				{
+					return;
+				}
+
+				processedGeneration = generation_;
+			}
+
+			std::exception_ptr exception = nullptr;
+
+			try
+			{
+				ProxyBase::components_[index]->Process();
+			}
+			catch (...)
+			{
+				exception = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(workerMutex_);
+
+				if (exception && !workerException_)
+				{
+					workerException_ = exception;
+				}
+
+				pendingWorkers_--;
+
+				if (pendingWorkers_ == 0)
+				{
+					doneCv_.notify_one();
+				}
+			}
+		}
+	}
+};
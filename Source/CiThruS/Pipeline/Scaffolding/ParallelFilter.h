@@ -37,7 +37,7 @@ public:
 		// Initialize input pins
 		TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
 		{
-			this->template GetInputPin<i>().Initialize(this);
+			this->template GetInputPin<i>().InitializeAsProxy(this);
 		});
 
 		ProxySinkBase<NInputs>::onInputPinsConnected_ = [this, filters...]()
@@ -76,6 +76,7 @@ protected:
 		TemplateUtility::For<NCurrentOutputs>([&]<uint8_t i>()
 		{
 			this->template GetOutputPin<NProcessedOutputs + i>().Initialize(this, currentFilter->template GetOutputPin<i>().GetFormat());
+			this->template GetOutputPin<NProcessedOutputs + i>().ForwardLentPlanesTo(currentFilter->template GetOutputPin<i>());
 		});
 
 		// Recursively connect the next filter
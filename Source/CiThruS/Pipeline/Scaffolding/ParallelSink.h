@@ -35,7 +35,7 @@ public:
 		// Initialize input pins
 		TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
 		{
-			this->template GetInputPin<i>().Initialize(this);
+			this->template GetInputPin<i>().InitializeAsProxy(this);
 		});
 
 		ProxySinkBase<NInputs>::onInputPinsConnected_ = [this, sinks...]()
@@ -39,6 +39,7 @@ public:
 		TemplateUtility::For<NInputsAndOutputs>([&, this]<uint8_t i>()
 		{
 			this->template GetOutputPin<i>().Initialize(this, this->template GetInputPin<i>().GetConnectedPin().GetFormat());
+			this->template GetOutputPin<i>().ForwardLentPlanesTo(this->template GetInputPin<i>().GetConnectedPin());
 		});
 	}
 };
@@ -38,7 +38,7 @@ public:
 		// Initialize input pins
 		TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
 		{
-			this->template GetInputPin<i>().Initialize(this);
+			this->template GetInputPin<i>().InitializeAsProxy(this);
 		});
 		
 		ProxySinkBase<NInputs>::onInputPinsConnected_ = [this, filters...]()
@@ -65,6 +65,7 @@ public:
 				TemplateUtility::For<NOutputs>([&, this]<uint8_t i>()
 				{
 					this->template GetOutputPin<i>().Initialize(this, lastFilter->template GetOutputPin<i>().GetFormat());
+					this->template GetOutputPin<i>().ForwardLentPlanesTo(lastFilter->template GetOutputPin<i>());
 				});
 			};
 
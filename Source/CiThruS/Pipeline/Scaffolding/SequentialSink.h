@@ -69,7 +69,7 @@ protected:
 		// Initialize input pins
 		TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
 		{
-			this->template GetInputPin<i>().Initialize(this);
+			this->template GetInputPin<i>().InitializeAsProxy(this);
 		});
 
 		ProxySinkBase<NInputs>::onInputPinsConnected_ = [this, filters..., sink]()
@@ -105,7 +105,7 @@ protected:
 	template <class TTuple, uint8_t NSinkInputs, std::size_t... I>
 	void UnrollComponents(PipelineSink<NSinkInputs>* sink, TTuple&& tuple, std::index_sequence<I...>)
 	{
-		ConstructInternal(sink, (std::get<I>(tuple), ...));
+		ConstructInternal(sink, std::get<I>(tuple)...);
 	}
 };
 
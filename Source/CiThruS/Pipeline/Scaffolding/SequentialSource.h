@@ -76,6 +76,7 @@ public:
 		TemplateUtility::For<NOutputs>([&, this]<uint8_t i>()
 		{
 			this->template GetOutputPin<i>().Initialize(this, lastFilter->template GetOutputPin<i>().GetFormat());
+			this->template GetOutputPin<i>().ForwardLentPlanesTo(lastFilter->template GetOutputPin<i>());
 		});
 	}
 
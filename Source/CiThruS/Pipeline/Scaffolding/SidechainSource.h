@@ -32,7 +32,7 @@ public:
 		// Initialize input pins
 		TemplateUtility::For<NInputs>([&, this]<uint8_t i>()
 		{
-			this->template GetInputPin<i>().Initialize(this);
+			this->template GetInputPin<i>().InitializeAsProxy(this);
 		});
 
 		ProxyBase::components_.resize(2);
@@ -60,6 +60,7 @@ public:
 				TemplateUtility::For<NOutputs>([&, this]<uint8_t i>()
 				{
 					this->template GetOutputPin<i>().Initialize(this, filter->template GetOutputPin<i>().GetFormat());
+					this->template GetOutputPin<i>().ForwardLentPlanesTo(filter->template GetOutputPin<i>());
 				});
 			};
 
@@ -37,7 +37,7 @@ void UScenarioBuilderComponent::BeginPlay()
 void UScenarioBuilderComponent::RunScenario(FString ScenarioName)
 {
 	// Load saved data file & start/run the scenario
-	KeypointGraph graph = trafficController_->GetRoadGraph();
+	const KeypointGraph& graph = trafficController_->GetRoadGraph();
 	FScenarioData data = ScenariosDataHandler::LoadData(ScenarioName);           
 	UE_LOG(LogTemp, Warning, TEXT("Loading Scenario: %s, (%s)"), *ScenarioName, *data.scenarioName) //Note: Pretty sure the data files don't contain the name anymore (data.scenarioName is empty always)
 	
@@ -193,7 +193,7 @@ FVector UScenarioBuilderComponent::GetClosestKeypoint(FVector Location)
 TArray<FVector> UScenarioBuilderComponent::GetRoute(FVector start, FVector end)
 {
 	// Get the full & fastest route from position A to position B
-	KeypointGraph graph = trafficController_->GetRoadGraph();
+	const KeypointGraph& graph = trafficController_->GetRoadGraph();
 	int startIndex = graph.GetClosestKeypoint(start);
 	int endIndex = graph.GetClosestKeypoint(end);
 	KeypointPath path = graph.FindPath(startIndex, endIndex);
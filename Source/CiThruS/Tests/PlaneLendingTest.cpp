@@ -0,0 +1,119 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Pipeline/Internal/PipelineSink.h"
+#include "Pipeline/Components/DepthToYuvConverter.h"
+#include "Pipeline/Components/ImageConcatenator.h"
+#include "Pipeline/Scaffolding/SequentialSink.h"
+#include "Pipeline/Scaffolding/ConcurrentSink.h"
+
+#include <vector>
+
+namespace
+{
+	// Remembers where the data it received was
+	class LendingTestSink : public PipelineSink<1>
+	{
+	public:
+		LendingTestSink(const uint8_t** receivedData) : receivedData_(receivedData)
+		{
+			GetInputPin<0>().Initialize(this);
+		}
+
+		virtual void Process() override
+		{
+			*receivedData_ = GetInputPin<0>().GetData();
+		}
+
+	protected:
+		const uint8_t** receivedData_;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlaneLendingScaffoldingTest, "CiThruS.Pipeline.PlaneLending.ThroughScaffolding",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlaneLendingScaffoldingTest::RunTest(const FString& parameters)
+{
+	const uint16_t width = 16;
+	const uint16_t height = 8;
+
+	std::vector<uint8_t> depthImage(width * height * 4, 200);
+
+	OutputPin sourcePin;
+	sourcePin.Initialize(this, "rgba");
+	sourcePin.SetData(depthImage.data());
+	sourcePin.SetSize(depthImage.size());
+
+	const uint8_t* receivedData = nullptr;
+
+	DepthToYuvConverter converter;
+	// The concatenator is behind scaffolding, which also connects to the converter's output pin
+	SequentialSink<1> sink(new ImageConcatenator<1>(width, height), new LendingTestSink(&receivedData));
+
+	converter.GetInputPin<0>().ConnectToOutputPin(sourcePin);
+	converter.OnInputPinsConnected();
+
+	sink.GetInputPin<0>().ConnectToOutputPin(converter.GetOutputPin<0>());
+	sink.OnInputPinsConnected();
+
+	TestEqual(TEXT("Planes were lent to the converter"), static_cast<int>(converter.GetOutputPin<0>().GetLentPlanes().size()), 3);
+
+	converter.Process();
+	sink.Process();
+
+	// With a single input the concatenated image starts with the first lent plane
+	TestTrue(TEXT("Converter wrote into the lent planes"), receivedData != nullptr && converter.GetOutputPin<0>().GetData() == receivedData);
+	TestEqual(TEXT("Luma was written"), receivedData != nullptr ? static_cast<int>(receivedData[0]) : -1, 200);
+	TestEqual(TEXT("Chroma was filled"), receivedData != nullptr ? static_cast<int>(receivedData[width * height]) : -1, 127);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlaneLendingSharedOutputTest, "CiThruS.Pipeline.PlaneLending.SharedOutput",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FPlaneLendingSharedOutputTest::RunTest(const FString& parameters)
+{
+	const uint16_t width = 16;
+	const uint16_t height = 8;
+
+	std::vector<uint8_t> depthImage(width * height * 4, 200);
+
+	OutputPin sourcePin;
+	sourcePin.Initialize(this, "rgba");
+	sourcePin.SetData(depthImage.data());
+	sourcePin.SetSize(depthImage.size());
+
+	const uint8_t* concatenatedData = nullptr;
+	const uint8_t* directData = nullptr;
+
+	DepthToYuvConverter converter;
+	// The second reader connects after the concatenator has already lent its planes
+	ConcurrentSink<1> sink(
+		{
+			new SequentialSink<1>(new ImageConcatenator<1>(width, height), new LendingTestSink(&concatenatedData)),
+			new LendingTestSink(&directData)
+		});
+
+	converter.GetInputPin<0>().ConnectToOutputPin(sourcePin);
+	converter.OnInputPinsConnected();
+
+	sink.GetInputPin<0>().ConnectToOutputPin(converter.GetOutputPin<0>());
+	sink.OnInputPinsConnected();
+
+	TestEqual(TEXT("Lent planes were revoked"), static_cast<int>(converter.GetOutputPin<0>().GetLentPlanes().size()), 0);
+
+	converter.Process();
+	sink.Process();
+
+	TestTrue(TEXT("Concatenator copied the data"), concatenatedData != nullptr && concatenatedData != directData);
+	TestEqual(TEXT("Concatenated luma is correct"), concatenatedData != nullptr ? static_cast<int>(concatenatedData[0]) : -1, 200);
+	TestEqual(TEXT("Direct luma is correct"), directData != nullptr ? static_cast<int>(directData[0]) : -1, 200);
+	TestEqual(TEXT("Direct chroma is correct"), directData != nullptr ? static_cast<int>(directData[width * height]) : -1, 127);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,54 @@
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Traffic/TrafficController.h"
+#include "Traffic/Entities/Pedestrian.h"
+#include "Engine/World.h"
+#include "Engine/Engine.h"
+
+#include <algorithm>
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTrafficQueryPedestrianTest, "CiThruS.Traffic.Query.PedestriansSpawnedAfterBeginPlay",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::EngineFilter)
+
+bool FTrafficQueryPedestrianTest::RunTest(const FString& parameters)
+{
+	UWorld* world = UWorld::CreateWorld(EWorldType::Game, false);
+	FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	worldContext.SetCurrentWorld(world);
+
+	ATrafficController* controller = world->SpawnActor<ATrafficController>();
+
+	// What BeginPlay does for pawns, without loading the graphs
+	controller->registeredPawns_.Empty();
+	controller->RegisterExistingPawns();
+
+	// Spawned afterwards, so it's only known to the controller as a simulated traffic entity
+	APedestrian* pedestrian = world->SpawnActor<APedestrian>(APedestrian::StaticClass(), FVector(100.0, 0.0, 0.0), FRotator::ZeroRotator);
+	controller->simulatedEntities_.push_back(pedestrian);
+
+	controller->IndexQueryActors();
+
+	TArray<AActor*> found = controller->GetEntitiesInArea(FVector::ZeroVector, FVector::ForwardVector, 1000.0f, 500.0f);
+
+	TestEqual(TEXT("Pedestrian spawned after BeginPlay is found once"), found.FilterByPredicate([&](AActor* actor) { return actor == pedestrian; }).Num(), 1);
+
+	// Pedestrians present when play begins must not be registered as pawns on top of being indexed
+	controller->registeredPawns_.Empty();
+	controller->RegisterExistingPawns();
+	controller->IndexQueryActors();
+
+	found = controller->GetEntitiesInArea(FVector::ZeroVector, FVector::ForwardVector, 1000.0f, 500.0f);
+
+	TestEqual(TEXT("Pedestrian present at BeginPlay is found once"), found.FilterByPredicate([&](AActor* actor) { return actor == pedestrian; }).Num(), 1);
+
+	controller->simulatedEntities_.erase(std::find(controller->simulatedEntities_.begin(), controller->simulatedEntities_.end(), pedestrian));
+
+	GEngine->DestroyWorldContext(world);
+	world->DestroyWorld(false);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "CollisionGrid.h"
+
+void CollisionGrid::Reset(const int32& entityCount)
+{
+	bounds_.resize(entityCount);
+}
+
+void CollisionGrid::Build()
+{
+	const int32 entityCount = static_cast<int32>(bounds_.size());
+
+	ranges_.resize(entityCount);
+
+	if (entityCount == 0)
+	{
+		columns_ = 0;
+		rows_ = 0;
+		cellStarts_.assign(1, 0);
+
+		return;
+	}
+
+	FVector2D min = bounds_[0].Min;
+	FVector2D max = bounds_[0].Max;
+	double totalEntitySize = 0.0;
+
+	for (const FBox2D& bounds : bounds_)
+	{
+		min = FVector2D::Min(min, bounds.Min);
+		max = FVector2D::Max(max, bounds.Max);
+
+		const FVector2D size = bounds.GetSize();
+
+		totalEntitySize += FMath::Max(size.X, size.Y);
+	}
+
+	cellSize_ = FMath::Max(static_cast<float>(CELL_SIZE_TO_ENTITY_SIZE * totalEntitySize / entityCount), MIN_CELL_SIZE);
+	origin_ = min;
+
+	const int64 maxCells = FMath::Max(entityCount * MAX_CELLS_PER_ENTITY, MIN_MAX_CELLS);
+
+	while (true)
+	{
+		columns_ = ToCell(max.X, origin_.X) + 1;
+		rows_ = ToCell(max.Y, origin_.Y) + 1;
+
+		if (static_cast<int64>(columns_) * rows_ <= maxCells)
+		{
+			break;
+		}
+
+		cellSize_ *= 2.0f;
+	}
+
+	const int32 cellCount = columns_ * rows_;
+
+	// Count the entities in each cell, turn the counts into start offsets and then place the entities
+	cellStarts_.assign(cellCount + 1, 0);
+
+	for (int32 i = 0; i < entityCount; i++)
+	{
+		CellRange& range = ranges_[i];
+
+		GetCellRange(bounds_[i], range);
+
+		for (int32 y = range.minY; y <= range.maxY; y++)
+		{
+			for (int32 x = range.minX; x <= range.maxX; x++)
+			{
+				cellStarts_[y * columns_ + x + 1]++;
+			}
+		}
+	}
+
+	for (int32 cell = 0; cell < cellCount; cell++)
+	{
+		cellStarts_[cell + 1] += cellStarts_[cell];
+	}
+
+	cellEntities_.resize(cellStarts_[cellCount]);
+	cellFill_.assign(cellStarts_.begin(), cellStarts_.end() - 1);
+
+	for (int32 i = 0; i < entityCount; i++)
+	{
+		const CellRange& range = ranges_[i];
+
+		for (int32 y = range.minY; y <= range.maxY; y++)
+		{
+			for (int32 x = range.minX; x <= range.maxX; x++)
+			{
+				cellEntities_[cellFill_[y * columns_ + x]++] = i;
+			}
+		}
+	}
+}
+
+bool CollisionGrid::GetCellRange(const FBox2D& bounds, CellRange& range) const
+{
+	if (columns_ == 0 || bounds.Max.X < origin_.X || bounds.Max.Y < origin_.Y)
+	{
+		return false;
+	}
+
+	range.minX = FMath::Max(ToCell(bounds.Min.X, origin_.X), 0);
+	range.minY = FMath::Max(ToCell(bounds.Min.Y, origin_.Y), 0);
+	range.maxX = FMath::Min(ToCell(bounds.Max.X, origin_.X), columns_ - 1);
+	range.maxY = FMath::Min(ToCell(bounds.Max.Y, origin_.Y), rows_ - 1);
+
+	return range.minX <= range.maxX && range.minY <= range.maxY;
+}
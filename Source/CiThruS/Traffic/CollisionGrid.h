@@ -0,0 +1,135 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <vector>
+
+// Uniform 2D grid on the XY plane for finding traffic entities that are close enough to collide.
+// Each entity is stored in every cell its bounds overlap, so the candidates for an entity are
+// found by looking only at the cells it overlaps. Meant to be rebuilt every tick: after the first
+// few ticks the storage has grown large enough and rebuilding no longer allocates memory
+class CollisionGrid
+{
+public:
+	CollisionGrid() : cellSize_(0.0f), origin_(FVector2D::ZeroVector), columns_(0), rows_(0) { }
+
+	// Must be called before setting the bounds of the entities
+	void Reset(const int32& entityCount);
+
+	// Can be called from multiple threads at once for different entities
+	inline void SetBounds(const int32& entity, const FBox2D& bounds) { bounds_[entity] = bounds; }
+
+	// Sorts the entities into cells. The cell size is chosen based on the size of the entities
+	void Build();
+
+	// Calls callback with every other entity whose bounds overlap the bounds of the given entity,
+	// each exactly once. Can be called from multiple threads at once
+	template <typename Callback>
+	void ForEachCandidate(const int32& entity, Callback callback) const;
+
+	// Calls callback with every entity whose bounds overlap the given bounds, each exactly once. Can be
+	// called from multiple threads at once
+	template <typename Callback>
+	void ForEachOverlapping(const FBox2D& bounds, Callback callback) const;
+
+	inline float GetCellSize() const { return cellSize_; }
+
+protected:
+	// Cells are roughly this many times the size of an average entity so that most entities overlap at most four cells
+	static constexpr float CELL_SIZE_TO_ENTITY_SIZE = 2.0f;
+	static constexpr float MIN_CELL_SIZE = 100.0f;
+
+	// The cell size is increased if the entities are spread out so thinly that the cells would take too much memory
+	static constexpr int64 MAX_CELLS_PER_ENTITY = 16;
+	static constexpr int64 MIN_MAX_CELLS = 4096;
+
+	struct CellRange
+	{
+		int32 minX;
+		int32 minY;
+		int32 maxX;
+		int32 maxY;
+	};
+
+	float cellSize_;
+	FVector2D origin_;
+	int32 columns_;
+	int32 rows_;
+
+	std::vector<FBox2D> bounds_;
+	std::vector<CellRange> ranges_;
+
+	// The entities of cell i are cellEntities_[cellStarts_[i]] to cellEntities_[cellStarts_[i + 1] - 1]
+	std::vector<int32> cellStarts_;
+	std::vector<int32> cellEntities_;
+	std::vector<int32> cellFill_;
+
+	// Clamped so that coordinates far outside the grid don't overflow
+	inline int32 ToCell(const double& coordinate, const double& origin) const { return static_cast<int32>(FMath::Clamp((coordinate - origin) / cellSize_, -1.0, 1.0e9)); }
+
+	// Returns false if the bounds are completely outside the grid
+	bool GetCellRange(const FBox2D& bounds, CellRange& range) const;
+
+	template <typename Callback>
+	void ForEachInCellRange(const CellRange& range, const FBox2D& bounds, const int32& skippedEntity, Callback callback) const;
+};
+
+template <typename Callback>
+void CollisionGrid::ForEachCandidate(const int32& entity, Callback callback) const
+{
+	// Template implementation must be in the header file
+
+	ForEachInCellRange(ranges_[entity], bounds_[entity], entity, callback);
+}
+
+template <typename Callback>
+void CollisionGrid::ForEachOverlapping(const FBox2D& bounds, Callback callback) const
+{
+	// Template implementation must be in the header file
+
+	CellRange range;
+
+	if (GetCellRange(bounds, range))
+	{
+		ForEachInCellRange(range, bounds, -1, callback);
+	}
+}
+
+template <typename Callback>
+void CollisionGrid::ForEachInCellRange(const CellRange& range, const FBox2D& bounds, const int32& skippedEntity, Callback callback) const
+{
+	// Template implementation must be in the header file
+
+	for (int32 y = range.minY; y <= range.maxY; y++)
+	{
+		for (int32 x = range.minX; x <= range.maxX; x++)
+		{
+			const int32 cell = y * columns_ + x;
+
+			for (int32 i = cellStarts_[cell]; i < cellStarts_[cell + 1]; i++)
+			{
+				const int32 otherEntity = cellEntities_[i];
+
+				if (otherEntity == skippedEntity)
+				{
+					continue;
+				}
+
+				const CellRange& otherRange = ranges_[otherEntity];
+
+				// Entities can share several cells, only report them in the first one
+				if (FMath::Max(range.minX, otherRange.minX) != x || FMath::Max(range.minY, otherRange.minY) != y)
+				{
+					continue;
+				}
+
+				if (!bounds.Intersect(bounds_[otherEntity]))
+				{
+					continue;
+				}
+
+				callback(otherEntity);
+			}
+		}
+	}
+}
@@ -92,6 +92,11 @@ std::vector<FVector> CollisionRectangle::GetCorners() const
 	};
 }
 
+FBox2D CollisionRectangle::GetFlatBounds() const
+{
+	return FBox2D(corners_, 4);
+}
+
 void CollisionRectangle::UpdateShape()
 {
 	// Calculate new corner positions
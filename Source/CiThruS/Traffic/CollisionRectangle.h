@@ -28,6 +28,14 @@ public:
 	inline FVector GetDimensions() const { return dimensions_; }
 	std::vector<FVector> GetCorners() const;
 
+	// Corners flattened to the XY plane in order around the rectangle
+	inline const FVector2D& GetFlatCorner(const int& index) const { return corners_[index]; }
+	inline float GetTop() const { return top_; }
+	inline float GetBottom() const { return bottom_; }
+
+	// Bounding box of the flattened corners
+	FBox2D GetFlatBounds() const;
+
 protected:
 	FVector2D corners_[4];
 	float top_;
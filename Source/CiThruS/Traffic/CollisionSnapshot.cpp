@@ -0,0 +1,147 @@
+#include "CollisionSnapshot.h"
+
+#ifdef CITHRUS_SSE41_AVAILABLE
+#include <emmintrin.h>
+#include <smmintrin.h>
+#endif // CITHRUS_SSE41_AVAILABLE
+
+#include <limits>
+
+void CollisionSnapshot::Reset(const int32& entityCount)
+{
+	const int32 rectangleCount = entityCount * 2;
+
+	cornersX_.resize(rectangleCount * 4);
+	cornersY_.resize(rectangleCount * 4);
+	normalsX_.resize(rectangleCount * 2);
+	normalsY_.resize(rectangleCount * 2);
+	tops_.resize(rectangleCount);
+	bottoms_.resize(rectangleCount);
+}
+
+void CollisionSnapshot::SetEntity(const int32& entity, const CollisionRectangle& collision, const CollisionRectangle& futureCollision)
+{
+	SetRectangle(entity * 2, collision);
+	SetRectangle(entity * 2 + 1, futureCollision);
+}
+
+FBox2D CollisionSnapshot::GetBounds(const int32& entity) const
+{
+	FVector2D min(std::numeric_limits<float>::max());
+	FVector2D max(std::numeric_limits<float>::lowest());
+
+	for (int32 i = entity * 8; i < entity * 8 + 8; i++)
+	{
+		min = FVector2D::Min(min, FVector2D(cornersX_[i], cornersY_[i]));
+		max = FVector2D::Max(max, FVector2D(cornersX_[i], cornersY_[i]));
+	}
+
+	return FBox2D(min - SEPARATION_TOLERANCE, max + SEPARATION_TOLERANCE);
+}
+
+bool CollisionSnapshot::MayBlock(const int32& entity, const int32& otherEntity) const
+{
+	const int32 current = entity * 2;
+	const int32 future = entity * 2 + 1;
+	const int32 otherCurrent = otherEntity * 2;
+	const int32 otherFuture = otherEntity * 2 + 1;
+
+	return AreIntersecting(current, otherCurrent)
+		|| AreIntersecting(future, otherCurrent)
+		|| AreIntersecting(future, otherFuture);
+}
+
+void CollisionSnapshot::SetRectangle(const int32& rectangle, const CollisionRectangle& collision)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		cornersX_[rectangle * 4 + i] = collision.GetFlatCorner(i).X;
+		cornersY_[rectangle * 4 + i] = collision.GetFlatCorner(i).Y;
+	}
+
+	// The flattened rectangle is a parallelogram at most, so the normals of two adjacent edges are enough
+	const FVector2D firstEdge = (collision.GetFlatCorner(1) - collision.GetFlatCorner(0)).GetSafeNormal();
+	const FVector2D secondEdge = (collision.GetFlatCorner(3) - collision.GetFlatCorner(0)).GetSafeNormal();
+
+	normalsX_[rectangle * 2] = -firstEdge.Y;
+	normalsY_[rectangle * 2] = firstEdge.X;
+	normalsX_[rectangle * 2 + 1] = -secondEdge.Y;
+	normalsY_[rectangle * 2 + 1] = secondEdge.X;
+
+	tops_[rectangle] = collision.GetTop();
+	bottoms_[rectangle] = collision.GetBottom();
+}
+
+bool CollisionSnapshot::AreIntersecting(const int32& a, const int32& b) const
+{
+	if (tops_[a] <= bottoms_[b] || bottoms_[a] >= tops_[b])
+	{
+		return false;
+	}
+
+	const float* aCornersX = &cornersX_[a * 4];
+	const float* aCornersY = &cornersY_[a * 4];
+	const float* bCornersX = &cornersX_[b * 4];
+	const float* bCornersY = &cornersY_[b * 4];
+
+#ifdef CITHRUS_SSE41_AVAILABLE
+	// Each lane tests one of the candidate separating axes: the two edge normals of both rectangles.
+	// The rectangles are projected onto all of them at once one corner at a time
+	const __m128 axesX = _mm_set_ps(normalsX_[b * 2 + 1], normalsX_[b * 2], normalsX_[a * 2 + 1], normalsX_[a * 2]);
+	const __m128 axesY = _mm_set_ps(normalsY_[b * 2 + 1], normalsY_[b * 2], normalsY_[a * 2 + 1], normalsY_[a * 2]);
+
+	__m128 aMin = _mm_set1_ps(std::numeric_limits<float>::max());
+	__m128 aMax = _mm_set1_ps(std::numeric_limits<float>::lowest());
+	__m128 bMin = aMin;
+	__m128 bMax = aMax;
+
+	for (int i = 0; i < 4; i++)
+	{
+		const __m128 aProjection = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(aCornersX[i]), axesX), _mm_mul_ps(_mm_set1_ps(aCornersY[i]), axesY));
+		const __m128 bProjection = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(bCornersX[i]), axesX), _mm_mul_ps(_mm_set1_ps(bCornersY[i]), axesY));
+
+		aMin = _mm_min_ps(aMin, aProjection);
+		aMax = _mm_max_ps(aMax, aProjection);
+		bMin = _mm_min_ps(bMin, bProjection);
+		bMax = _mm_max_ps(bMax, bProjection);
+	}
+
+	const __m128 tolerance = _mm_set1_ps(SEPARATION_TOLERANCE);
+
+	// The rectangles are separated if their projections don't overlap on any of the axes
+	const __m128 separated = _mm_or_ps(
+		_mm_cmpgt_ps(bMin, _mm_add_ps(aMax, tolerance)),
+		_mm_cmpgt_ps(aMin, _mm_add_ps(bMax, tolerance)));
+
+	return _mm_movemask_ps(separated) == 0;
+#else
+	const float axesX[4] = { normalsX_[a * 2], normalsX_[a * 2 + 1], normalsX_[b * 2], normalsX_[b * 2 + 1] };
+	const float axesY[4] = { normalsY_[a * 2], normalsY_[a * 2 + 1], normalsY_[b * 2], normalsY_[b * 2 + 1] };
+
+	for (int axis = 0; axis < 4; axis++)
+	{
+		float aMin = std::numeric_limits<float>::max();
+		float aMax = std::numeric_limits<float>::lowest();
+		float bMin = aMin;
+		float bMax = aMax;
+
+		for (int i = 0; i < 4; i++)
+		{
+			const float aProjection = aCornersX[i] * axesX[axis] + aCornersY[i] * axesY[axis];
+			const float bProjection = bCornersX[i] * axesX[axis] + bCornersY[i] * axesY[axis];
+
+			aMin = FMath::Min(aMin, aProjection);
+			aMax = FMath::Max(aMax, aProjection);
+			bMin = FMath::Min(bMin, bProjection);
+			bMax = FMath::Max(bMax, bProjection);
+		}
+
+		if (bMin > aMax + SEPARATION_TOLERANCE || aMin > bMax + SEPARATION_TOLERANCE)
+		{
+			return false;
+		}
+	}
+
+	return true;
+#endif // CITHRUS_SSE41_AVAILABLE
+}
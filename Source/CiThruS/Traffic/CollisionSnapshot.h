@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CollisionRectangle.h"
+#include "Optional/Sse41.h"
+
+#include "CoreMinimal.h"
+
+#include <vector>
+
+// Copy of the current and predicted future collision rectangles of all traffic entities, taken once
+// per tick. The rectangles are stored as contiguous arrays of corners, edge normals and heights so
+// that candidate pairs from the broadphase can be tested with SIMD separating axis tests without
+// going through the entities
+class CollisionSnapshot
+{
+public:
+	// Must be called before setting the rectangles of the entities
+	void Reset(const int32& entityCount);
+
+	// Can be called from multiple threads at once for different entities
+	void SetEntity(const int32& entity, const CollisionRectangle& collision, const CollisionRectangle& futureCollision);
+
+	// Covers both rectangles of the entity on the XY plane
+	FBox2D GetBounds(const int32& entity) const;
+
+	// Traffic entities can only block each other if either rectangle of entity intersects the current
+	// rectangle of otherEntity or their future rectangles intersect, so the entities only need to check
+	// the pairs for which this returns true. Errs on the side of reporting an intersection
+	bool MayBlock(const int32& entity, const int32& otherEntity) const;
+
+protected:
+	// Rectangles closer than this (in cm) count as intersecting to absorb rounding errors from storing coordinates as floats
+	static constexpr float SEPARATION_TOLERANCE = 1.0f;
+
+	// Each entity has two rectangles: the current one at index 2 * entity and the future one right after it.
+	// Every rectangle has four corners, two edge normals and a top and bottom height
+	std::vector<float> cornersX_;
+	std::vector<float> cornersY_;
+	std::vector<float> normalsX_;
+	std::vector<float> normalsY_;
+	std::vector<float> tops_;
+	std::vector<float> bottoms_;
+
+	void SetRectangle(const int32& rectangle, const CollisionRectangle& collision);
+
+	bool AreIntersecting(const int32& rectangle, const int32& otherRectangle) const;
+};
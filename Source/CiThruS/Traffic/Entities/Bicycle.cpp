@@ -34,6 +34,8 @@ void ABicycle::Destroyed()
 		trafficController_->InvalidateTrafficEntity(this);
 	}
 
+	pathFollower_.LeaveLane();
+
 	Super::Destroyed();
 }
 
@@ -58,7 +60,6 @@ void ABicycle::Tick(float deltaTime)
 {
 	Super::Tick(deltaTime);
 
-	UpdateZone(GetController());
 	if (!simulate_)
 	{
 		return;
@@ -34,6 +34,8 @@ void ACar::Destroyed()
 		trafficController_->InvalidateTrafficEntity(this);
 	}
 
+	pathFollower_.LeaveLane();
+
 	Super::Destroyed();
 }
 
@@ -41,7 +43,6 @@ void ACar::Tick(float deltaTime)
 {
 	Super::Tick(deltaTime);
 	frameCounter_++;
-	UpdateZone(GetController());
 
 
 	if (!simulate_)
@@ -313,6 +314,7 @@ void ACar::ClearBlockingCollisions()
 {
 	blocked_ = false;
 	blockedByFuturePawn_ = false;
+	blockingEntityName_ = FString(TEXT("None"));
 }
 
 bool ACar::BlockedBy(ITrafficEntity* trafficEntity) const
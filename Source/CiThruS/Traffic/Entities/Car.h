@@ -67,6 +67,9 @@ public:
 	inline CurvePathFollower GetPathFollower() const { return pathFollower_; }
 	inline ATrafficController* GetController() const { return trafficController_; }
 
+	// The nearest entity ahead on the same lane and the distance to it, nullptr if there is nobody ahead
+	inline AActor* GetLeader(float& gap) const { return pathFollower_.GetLeader(gap); }
+
 	inline void SetMoveSpeed(float speed) { targetSpeed_ = FMath::Clamp(speed, -driverCharacteristics_.maxSpeed, driverCharacteristics_.maxSpeed); }
 	inline void SetInstantSpeed(float speed) { moveSpeed_ = speed; }
 	inline void ResetMoveSpeed() { SetMoveSpeed(trafficController_->GetRegulatedSpeedAtPoint(pathFollower_.GetLocation()) * driverCharacteristics_.normalSpeedMultiplier); }
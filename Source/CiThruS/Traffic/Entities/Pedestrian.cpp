@@ -64,7 +64,6 @@ void APedestrian::Simulate(const KeypointGraph* graph)
 void APedestrian::Tick(float deltaTime)
 {
 	Super::Tick(deltaTime);
-	UpdateZone(GetController());
 
 	if (!simulate_)
 	{
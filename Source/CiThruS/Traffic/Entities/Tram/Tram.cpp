@@ -31,13 +31,14 @@ void ATram::Destroyed()
 	if (trafficController_ != nullptr)
 		trafficController_->InvalidateTrafficEntity(this);
 
+	pathFollower_.LeaveLane();
+
 	Super::Destroyed();
 }
 
 void ATram::Tick(float deltaTime)
 {
 	Super::Tick(deltaTime);
-	UpdateZone(GetController());
 
 	if (!simulate_)
 	{
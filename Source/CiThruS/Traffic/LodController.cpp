@@ -147,6 +147,31 @@ void LodController::UpdateAllLods()
 	UPubSubCommunicator::PublishTrafficArray("Traffic", publishableActors);
 }
 
+std::vector<ITrafficEntity*> LodController::GetEntitiesInView(const FVector& viewLocation, const FRotator& viewRotation, const float& fov, const float& aspectRatio) const
+{
+	std::vector<ITrafficEntity*> entitiesInView;
+
+	const FMatrix viewMatrix = FTransform(viewRotation, viewLocation).Inverse().ToMatrixNoScale();
+	const float tanInverse = 1.0f / tan(FMath::DegreesToRadians(fov / 2.0f));
+	const float aspectRatioInverse = 1.0f / aspectRatio;
+	const float farDistanceSquared = farDistance_ * farDistance_;
+
+	for (auto it = entityLodInfo_.begin(); it != entityLodInfo_.end(); it++)
+	{
+		ITrafficEntity* entity = it->second.entity;
+
+		if ((entity->GetCollisionRectangle().GetPosition() - viewLocation).SquaredLength() > farDistanceSquared
+			|| !EntityInCameraView(entity, viewLocation, viewMatrix, tanInverse, aspectRatioInverse))
+		{
+			continue;
+		}
+
+		entitiesInView.push_back(entity);
+	}
+
+	return entitiesInView;
+}
+
 void LodController::GetCameraViewProperties(FVector& cameraLocation, FMatrix& cameraViewMatrix, float& cameraTanInverse, float& aspectRatioInverse)
 {
 	FMinimalViewInfo cameraViewInfo;
@@ -213,7 +238,7 @@ void LodController::GetCameraViewProperties(FVector& cameraLocation, FMatrix& ca
 	}
 }
 
-bool LodController::EntityInCameraView(ITrafficEntity* entity, FVector& cameraLocation, FMatrix& cameraViewMatrix, float& cameraTanInverse, float& aspectRatioInverse)
+bool LodController::EntityInCameraView(ITrafficEntity* entity, const FVector& cameraLocation, const FMatrix& cameraViewMatrix, const float& cameraTanInverse, const float& aspectRatioInverse) const
 {
 	bool visibleInFront = false;
 	bool visibleInBack = false;
@@ -21,6 +21,10 @@ public:
 
 	void UpdateAllLods();
 
+	// Entities within the LOD distance that are in the given view. The entities the LOD update considers near are
+	// in view of the player camera, which isn't necessarily the view the caller is interested in
+	std::vector<ITrafficEntity*> GetEntitiesInView(const FVector& viewLocation, const FRotator& viewRotation, const float& fov, const float& aspectRatio) const;
+
 	inline bool GetVisualizeViewFrustrum() const { return visualizeViewFrustrum_; }
 	inline void SetVisualizeViewFrustrum(const bool& value) { visualizeViewFrustrum_ = value; }
 
@@ -52,5 +56,5 @@ private:
 	//// float aspectRatioInverse -- one over the aspect ratio of the camera
 	void GetCameraViewProperties(FVector& cameraLocation, FMatrix& cameraViewMatrix, float& cameraTanInverse, float& aspectRatioInverse);
 	// Returns true if the given entity is in view
-	bool EntityInCameraView(ITrafficEntity* entity, FVector& cameraLocation, FMatrix& cameraViewMatrix, float& cameraTanInverse, float& aspectRatioInverse);
+	bool EntityInCameraView(ITrafficEntity* entity, const FVector& cameraLocation, const FMatrix& cameraViewMatrix, const float& cameraTanInverse, const float& aspectRatioInverse) const;
 };
@@ -27,6 +27,8 @@ void CurvePathFollower::Initialize(const KeypointGraph* graph, AActor* trafficEn
 	{
 		NewPath(true);	
 	}
+
+	UpdateLane();
 }
 
 void CurvePathFollower::Advance(const float& step)
@@ -58,6 +60,8 @@ void CurvePathFollower::Advance(const float& step)
 		// teleport to a new spawnpoint (teleport to a spawnpoint or get deleted & spawn new car from a parking space)
 		NewPath(path_.graph->GetOutBoundKeypoints(path_.keypoints.Last()).size() != 0);	
 	}
+
+	UpdateLane();
 }
 
 FVector CurvePathFollower::GetLocationAt(const int& point, const float& progress, FVector& tangent, std::shared_ptr<ICurve> curve) const
@@ -191,7 +195,7 @@ void CurvePathFollower::NewPath(const bool& fromNearestKeypoint)
 	if (fromNearestKeypoint) // the entity probably shouldn't move if we want to create a path from nearest keypoint (it's already close to it, so just create a custom path to that keypoint)
 	{
 		int closestIndex = graph->GetClosestKeypoint(trafficEntity_->GetActorLocation());
-		std::vector<int> outbounds = graph->GetOutBoundKeypoints(closestIndex);
+		std::span<const int> outbounds = graph->GetOutBoundKeypoints(closestIndex);
 
 		// We need to start from a random outbound keypoint, to prevent car going backwards
 		path_ = graph->GetRandomPathFrom(graph->GetClosestKeypoint(trafficEntity_->GetActorLocation()), GetKeypointRuleExceptions());
@@ -241,6 +245,71 @@ void CurvePathFollower::SetPointAndProgress(int point, float progress)
 	progressToNextPoint_ = progress;
 
 	currentCurve_ = CreateCurveFromPoint(currentPoint_);
+
+	UpdateLane();
+}
+
+AActor* CurvePathFollower::GetLeader(float& gap) const
+{
+	if (path_.graph == nullptr || laneEnd_ < 0)
+	{
+		return nullptr;
+	}
+
+	// Custom points are not part of the graph so there are no lanes to look at past them
+	const int nextTo = laneEnd_ + 1 < path_.keypoints.Num() ? path_.keypoints[laneEnd_ + 1] : -1;
+
+	return path_.graph->GetLaneOccupancy().GetLeader(laneHandle_, trafficEntity_, nextTo, gap);
+}
+
+void CurvePathFollower::LeaveLane()
+{
+	if (path_.graph != nullptr)
+	{
+		path_.graph->GetLaneOccupancy().Leave(laneHandle_, trafficEntity_);
+	}
+
+	laneHandle_ = LaneOccupancy::INVALID_HANDLE;
+	laneEnd_ = -1;
+}
+
+void CurvePathFollower::UpdateLane()
+{
+	const int keypointCount = path_.keypoints.Num();
+
+	// The entity may have been destroyed while starting a new path
+	if (path_.graph == nullptr || keypointCount < 2 || !IsValid(trafficEntity_))
+	{
+		LeaveLane();
+		return;
+	}
+
+	// Each curve starts and ends halfway between two keypoints, so the entity passes keypoint currentPoint_ halfway
+	// through the curve (except on the first curve, which starts at the first keypoint)
+	const int laneEnd = FMath::Clamp(progressToNextPoint_ < 0.5f && currentPoint_ > 0 ? currentPoint_ : currentPoint_ + 1, 1, keypointCount - 1);
+	const int from = path_.keypoints[laneEnd - 1];
+	const int to = path_.keypoints[laneEnd];
+
+	if (from < 0 || to < 0)
+	{
+		LeaveLane();
+		return;
+	}
+
+	const FVector linkStart = path_.graph->GetKeypointPosition(from);
+	const FVector link = path_.graph->GetKeypointPosition(to) - linkStart;
+	const float linkLength = link.Size();
+
+	if (linkLength <= 0.0f)
+	{
+		LeaveLane();
+		return;
+	}
+
+	const float distance = FMath::Clamp(FVector::DotProduct(GetLocation() - linkStart, link) / linkLength, 0.0f, linkLength);
+
+	laneHandle_ = path_.graph->GetLaneOccupancy().Update(laneHandle_, trafficEntity_, from, to, linkLength, distance);
+	laneEnd_ = laneEnd;
 }
 
 void CurvePathFollower::FirstTimeSpawn()
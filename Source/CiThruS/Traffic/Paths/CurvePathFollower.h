@@ -49,6 +49,13 @@ public:
 	// Is the path ending on next target?
 	inline bool IsLastTarget() const { return (PointCount() - 1) == currentPoint_; }
 
+	// Get the nearest entity ahead on the same lane and the distance to it along the lane. Only looks one link
+	// ahead of the current link. Returns nullptr if there is nobody ahead
+	AActor* GetLeader(float& gap) const;
+
+	// Must be called when the entity is destroyed so that it doesn't remain in the lane occupancy lists of the graph
+	void LeaveLane();
+
 protected:
 	KeypointPath path_;
 	AActor* trafficEntity_; // Entity controlled by this PathFollower
@@ -59,6 +66,12 @@ protected:
 
 	bool makeSCurve_ = true;
 
+	// The link the entity is on in the lane occupancy lists of the graph ends at path_.keypoints[laneEnd_]
+	LaneOccupancy::Handle laneHandle_ = LaneOccupancy::INVALID_HANDLE;
+	int laneEnd_ = -1;
+
+	void UpdateLane();
+
 	void AdvancePointAndProgress(int& startPoint, float& startProgress, std::shared_ptr<ICurve>& curve, float distance) const;
 
 	FVector GetLocationAt(const int& target, const float& progress, FVector& tangent, std::shared_ptr<ICurve> curve) const;
@@ -1,23 +1,98 @@
 #include "KeypointGraph.h"
+#include "KeypointGraphContainer.h"
 #include "Misc/Debug.h"
 #include "Traffic/TrafficController.h"
+#include "Pipeline/Internal/MappedFile.h"
 
 #include "Kismet/KismetMathLibrary.h"
 #include "Engine/World.h"
+#include "Algo/Reverse.h"
+#include "HAL/FileManager.h"
+#include "Misc/PackageName.h"
+#include "UObject/Package.h"
+#include "EngineUtils.h"
+#include "LandscapeProxy.h"
+#include "Physics/PhysicsInterfaceCore.h"
+#include "Runtime/Core/Public/Async/ParallelFor.h"
 
 #include <utility>
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
 
 #define RANDOM_PATH_MAX_LENGTH 300
 
+namespace
+{
+	// State of a path search, indexed by keypoint. Reused between searches so that a search doesn't allocate
+	// anything once the arrays have grown to fit the graph. Keypoints are only valid for the search whose
+	// number is stored for them, so nothing needs to be cleared between searches either
+	struct PathSearchScratch
+	{
+		std::vector<float> cost;
+		std::vector<int> parent;
+		std::vector<uint32> reached;
+		std::vector<uint32> closed;
+
+		// <estimated total cost, keypoint>, a min-heap
+		std::vector<std::pair<float, int>> open;
+
+		uint32 search = 0;
+
+		void Begin(const int& keypointCount)
+		{
+			if (cost.size() < keypointCount)
+			{
+				cost.resize(keypointCount);
+				parent.resize(keypointCount);
+				reached.resize(keypointCount, 0);
+				closed.resize(keypointCount, 0);
+			}
+
+			open.clear();
+			search++;
+
+			// Stale search numbers could be mistaken for the current search after wrapping around
+			if (search == 0)
+			{
+				std::fill(reached.begin(), reached.end(), 0);
+				std::fill(closed.begin(), closed.end(), 0);
+				search = 1;
+			}
+		}
+
+		inline bool IsReached(const int& keypoint) const { return reached[keypoint] == search; }
+		inline bool IsClosed(const int& keypoint) const { return closed[keypoint] == search; }
+		inline void Close(const int& keypoint) { closed[keypoint] = search; }
+
+		void Open(const int& keypoint, const int& from, const float& keypointCost, const float& estimate)
+		{
+			cost[keypoint] = keypointCost;
+			parent[keypoint] = from;
+			reached[keypoint] = search;
+
+			open.push_back({ estimate, keypoint });
+			std::push_heap(open.begin(), open.end(), std::greater<>());
+		}
+	};
+
+	thread_local PathSearchScratch pathSearchScratch;
+}
+
 void KeypointGraph::AddKeypoint(const FVector& position)
 {
+	Thaw();
+
 	keypoints_.push_back({ position });
 }
 
 void KeypointGraph::RemoveKeypoint(const int& kpIndex)
 {
+	Thaw();
+
 	// Remove links that reference this keypoint
 	for (auto it = links_.begin(); it != links_.end();)
 	{
@@ -65,6 +140,8 @@ void KeypointGraph::RemoveKeypoint(const int& kpIndex)
 
 void KeypointGraph::LinkKeypoints(const int& firstKeypointIndex, const int& secondKeypointIndex)
 {
+	Thaw();
+
 	links_.push_back(Link{ firstKeypointIndex, secondKeypointIndex });
 
 	keypoints_[firstKeypointIndex].outboundKeypoints.push_back(secondKeypointIndex);
@@ -83,6 +160,8 @@ void KeypointGraph::OvertakeSetup(const int& lane1StartIndex, const int& lane1En
 
 void KeypointGraph::SetKeypointRules(const int& kpIndex, const int32& rules)
 {
+	Thaw();
+
 	if (keypoints_.size() <= kpIndex)
 	{
 		return;
@@ -98,10 +177,116 @@ void KeypointGraph::ClearKeypoints()
 	overtakes_.clear();
 	entryPoints_.clear();
 	spawnPoints_.clear();
+	laneOccupancy_.Clear();
+	landmarks_.Clear();
+
+	editableLayoutValid_ = true;
+	groundStamp_ = 0;
+
+	Freeze();
+}
+
+void KeypointGraph::Freeze()
+{
+	// Nothing has been edited since the graph was loaded from a binary file
+	if (!editableLayoutValid_)
+	{
+		return;
+	}
+
+	const int keypointCount = keypoints_.size();
+
+	positions_.resize(keypointCount);
+	rules_.resize(keypointCount);
+	outboundStarts_.resize(keypointCount + 1);
+	inboundStarts_.resize(keypointCount + 1);
+	outbound_.clear();
+	inbound_.clear();
+
+	for (int i = 0; i < keypointCount; i++)
+	{
+		const Keypoint& keypoint = keypoints_[i];
+
+		positions_[i] = keypoint.position;
+		rules_[i] = keypoint.rules;
+
+		outboundStarts_[i] = outbound_.size();
+		inboundStarts_[i] = inbound_.size();
+
+		outbound_.insert(outbound_.end(), keypoint.outboundKeypoints.begin(), keypoint.outboundKeypoints.end());
+		inbound_.insert(inbound_.end(), keypoint.inboundKeypoints.begin(), keypoint.inboundKeypoints.end());
+	}
+
+	outboundStarts_[keypointCount] = outbound_.size();
+	inboundStarts_[keypointCount] = inbound_.size();
+
+	compactLayoutValid_ = true;
+
+	// Landmark distances are wrong for an edited graph and could make FindPath miss the shortest path
+	if (landmarks_.IsBuilt() && !landmarks_.Matches(*this))
+	{
+		landmarks_.Clear();
+	}
+}
+
+void KeypointGraph::UpdateEditableLayout()
+{
+	if (editableLayoutValid_)
+	{
+		return;
+	}
+
+	const int keypointCount = positions_.size();
+
+	keypoints_.resize(keypointCount);
+	links_.clear();
+	links_.reserve(outbound_.size());
+
+	for (int i = 0; i < keypointCount; i++)
+	{
+		const std::span<const int> outbounds = GetOutBoundKeypoints(i);
+		const std::span<const int> inbounds = GetInboundKeypoints(i);
+
+		keypoints_[i].position = positions_[i];
+		keypoints_[i].rules = rules_[i];
+		keypoints_[i].outboundKeypoints.assign(outbounds.begin(), outbounds.end());
+		keypoints_[i].inboundKeypoints.assign(inbounds.begin(), inbounds.end());
+
+		for (const int& outbound : outbounds)
+		{
+			links_.push_back(Link{ i, outbound });
+		}
+	}
+
+	editableLayoutValid_ = true;
+}
+
+std::pair<int, int> KeypointGraph::GetLinkKeypoints(const int& linkIndex) const
+{
+	if (editableLayoutValid_)
+	{
+		return links_[linkIndex];
+	}
+
+	// The outbound links of each keypoint are stored in keypoint order, so the link belongs to the last keypoint
+	// whose links start at or before it
+	const int from = std::upper_bound(outboundStarts_.begin(), outboundStarts_.end(), linkIndex) - outboundStarts_.begin() - 1;
+
+	return { from, outbound_[linkIndex] };
+}
+
+void KeypointGraph::Thaw()
+{
+	UpdateEditableLayout();
+
+	compactLayoutValid_ = false;
+	groundStamp_ = 0;
 }
 
 bool KeypointGraph::SaveToFile(const std::string& filePath)
 {
+	UpdateEditableLayout();
+
 	std::ofstream outfile(filePath);
 
 	if (!outfile.is_open())
@@ -277,30 +462,365 @@ bool KeypointGraph::LoadFromFile(const std::string& filePath)
 
 	inFile.close();
 
+	Freeze();
 	UpdateEntryPoints();
 
 	return true;
 }
 
+namespace
+{
+	template <typename T>
+	inline void WriteValues(std::ofstream& outFile, const T* values, const size_t& count)
+	{
+		outFile.write(reinterpret_cast<const char*>(values), count * sizeof(T));
+	}
+
+	// Checks that all the given keypoint indices point to existing keypoints
+	bool IsValidKeypointIndices(const int32* keypoints, const uint32& keypointCount, const uint64& count)
+	{
+		for (uint64 i = 0; i < count; i++)
+		{
+			if (keypoints[i] < 0 || static_cast<uint32>(keypoints[i]) >= keypointCount)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Checks that the CSR offsets are in order and only point to existing keypoints
+	bool IsValidAdjacency(const int32* starts, const int32* keypoints, const uint32& keypointCount, const uint32& count)
+	{
+		if (starts[0] != 0 || static_cast<uint32>(starts[keypointCount]) != count)
+		{
+			return false;
+		}
+
+		for (uint32 i = 0; i < keypointCount; i++)
+		{
+			if (starts[i] > starts[i + 1])
+			{
+				return false;
+			}
+		}
+
+		return IsValidKeypointIndices(keypoints, keypointCount, count);
+	}
+}
+
+bool KeypointGraph::SaveToBinaryFile(const std::string& filePath, const uint64& sourceStamp)
+{
+	if (!compactLayoutValid_)
+	{
+		Freeze();
+	}
+
+	std::ofstream outFile(filePath, std::ios::binary);
+
+	if (!outFile.is_open())
+	{
+		std::cout << "couldn't open file " << filePath << std::endl;
+		return false;
+	}
+
+	KeypointGraphContainer::FileHeader header;
+
+	header.magic = KeypointGraphContainer::FILE_MAGIC;
+	header.version = KeypointGraphContainer::VERSION;
+	header.sourceStamp = sourceStamp;
+	header.groundStamp = groundStamp_;
+	header.keypointCount = positions_.size();
+	header.outboundCount = outbound_.size();
+	header.inboundCount = inbound_.size();
+	header.spawnPointCount = spawnPoints_.size();
+	header.overtakeCount = overtakes_.size();
+	header.reserved = 0;
+
+	std::vector<KeypointGraphContainer::Position> positions;
+	positions.reserve(positions_.size());
+
+	for (const FVector& position : positions_)
+	{
+		positions.push_back({ position.X, position.Y, position.Z });
+	}
+
+	std::vector<KeypointGraphContainer::Overtake> overtakes;
+	overtakes.reserve(overtakes_.size());
+
+	for (const OvertakeLaneLink& overtake : overtakes_)
+	{
+		overtakes.push_back({ overtake.first.first, overtake.first.second, overtake.second.first, overtake.second.second });
+	}
+
+	WriteValues(outFile, &header, 1);
+	WriteValues(outFile, positions.data(), positions.size());
+	WriteValues(outFile, rules_.data(), rules_.size());
+	WriteValues(outFile, outboundStarts_.data(), outboundStarts_.size());
+	WriteValues(outFile, outbound_.data(), outbound_.size());
+	WriteValues(outFile, inboundStarts_.data(), inboundStarts_.size());
+	WriteValues(outFile, inbound_.data(), inbound_.size());
+	WriteValues(outFile, spawnPoints_.data(), spawnPoints_.size());
+	WriteValues(outFile, overtakes.data(), overtakes.size());
+
+	return outFile.good();
+}
+
+bool KeypointGraph::LoadFromBinaryFile(const std::string& filePath, const uint64& sourceStamp)
+{
+	try
+	{
+		MappedFile file(filePath);
+
+		if (file.GetSize() < sizeof(KeypointGraphContainer::FileHeader))
+		{
+			return false;
+		}
+
+		const uint8_t* data = file.GetData();
+		const KeypointGraphContainer::FileHeader& header = *reinterpret_cast<const KeypointGraphContainer::FileHeader*>(data);
+
+		if (header.magic != KeypointGraphContainer::FILE_MAGIC || header.version != KeypointGraphContainer::VERSION)
+		{
+			return false;
+		}
+
+		// The text file has been edited since it was converted
+		if (sourceStamp != 0 && header.sourceStamp != sourceStamp)
+		{
+			return false;
+		}
+
+		// Keypoints are indexed with ints, so larger counts can't come from a valid graph
+		if (header.keypointCount > INT32_MAX || header.outboundCount > INT32_MAX || header.inboundCount > INT32_MAX
+			|| header.spawnPointCount > INT32_MAX || header.overtakeCount > INT32_MAX)
+		{
+			return false;
+		}
+
+		const uint64_t keypointCount = header.keypointCount;
+
+		const uint64_t expectedSize = sizeof(KeypointGraphContainer::FileHeader)
+			+ keypointCount * sizeof(KeypointGraphContainer::Position)
+			+ (keypointCount + (keypointCount + 1) * 2 + header.outboundCount + header.inboundCount + header.spawnPointCount) * sizeof(int32_t)
+			+ header.overtakeCount * sizeof(KeypointGraphContainer::Overtake);
+
+		if (file.GetSize() != expectedSize)
+		{
+			return false;
+		}
+
+		const KeypointGraphContainer::Position* positions = reinterpret_cast<const KeypointGraphContainer::Position*>(data + sizeof(KeypointGraphContainer::FileHeader));
+		const int32_t* rules = reinterpret_cast<const int32_t*>(positions + keypointCount);
+		const int32_t* outboundStarts = rules + keypointCount;
+		const int32_t* outbound = outboundStarts + keypointCount + 1;
+		const int32_t* inboundStarts = outbound + header.outboundCount;
+		const int32_t* inbound = inboundStarts + keypointCount + 1;
+		const int32_t* spawnPoints = inbound + header.inboundCount;
+		const KeypointGraphContainer::Overtake* overtakes = reinterpret_cast<const KeypointGraphContainer::Overtake*>(spawnPoints + header.spawnPointCount);
+
+		// A corrupted file could otherwise make queries read outside of the arrays. The file size check above already
+		// guarantees that there is a rule for every keypoint
+		if (!IsValidAdjacency(outboundStarts, outbound, header.keypointCount, header.outboundCount)
+			|| !IsValidAdjacency(inboundStarts, inbound, header.keypointCount, header.inboundCount)
+			|| !IsValidKeypointIndices(spawnPoints, header.keypointCount, header.spawnPointCount)
+			|| !IsValidKeypointIndices(reinterpret_cast<const int32_t*>(overtakes), header.keypointCount, static_cast<uint64_t>(header.overtakeCount) * 4))
+		{
+			return false;
+		}
+
+		ClearKeypoints();
+
+		// The arrays are already in the compact layout, so they're copied over as is
+		positions_.resize(keypointCount);
+
+		for (uint64_t i = 0; i < keypointCount; i++)
+		{
+			positions_[i] = FVector(positions[i].x, positions[i].y, positions[i].z);
+		}
+
+		rules_.assign(rules, rules + keypointCount);
+		outboundStarts_.assign(outboundStarts, outboundStarts + keypointCount + 1);
+		outbound_.assign(outbound, outbound + header.outboundCount);
+		inboundStarts_.assign(inboundStarts, inboundStarts + keypointCount + 1);
+		inbound_.assign(inbound, inbound + header.inboundCount);
+		spawnPoints_.assign(spawnPoints, spawnPoints + header.spawnPointCount);
+
+		for (uint32 i = 0; i < header.overtakeCount; i++)
+		{
+			OvertakeSetup(overtakes[i].lane1Start, overtakes[i].lane1End, overtakes[i].lane2Start, overtakes[i].lane2End);
+		}
+
+		// The editable layout is only built if the graph is edited
+		editableLayoutValid_ = false;
+		groundStamp_ = header.groundStamp;
+
+		UpdateEntryPoints();
+
+		return true;
+	}
+	catch (const std::exception&)
+	{
+		// The file doesn't exist yet or couldn't be mapped
+		return false;
+	}
+}
+
+bool KeypointGraph::LoadFromFileCached(const std::string& filePath, const std::string& binaryFilePath, UWorld* world)
+{
+	// If the text file is missing, e.g. in a packaged build that only ships the binary file, the stamp is 0 and any
+	// binary file is accepted
+	const uint64 sourceStamp = GetFileStamp(filePath);
+
+	const bool loaded = LoadFromBinaryFile(binaryFilePath, sourceStamp);
+
+	// The aligned heights are cached in the binary file, so the ground only needs to be traced again if it has changed
+	if (loaded && (world == nullptr || groundStamp_ == GetGroundStamp(world)))
+	{
+		return true;
+	}
+
+	// Align the original heights from the text file rather than heights that were aligned with some other ground
+	if ((!loaded || sourceStamp != 0) && !LoadFromFile(filePath))
+	{
+		return false;
+	}
+
+	if (world != nullptr)
+	{
+		AlignWithWorldGround(world);
+	}
+
+	if (!SaveToBinaryFile(binaryFilePath, sourceStamp))
+	{
+		std::cout << "couldn't save binary graph to " << binaryFilePath << std::endl;
+	}
+
+	return true;
+}
+
+bool KeypointGraph::ConvertToBinaryFile(const std::string& filePath, const std::string& binaryFilePath)
+{
+	KeypointGraph graph;
+
+	if (!graph.LoadFromFile(filePath))
+	{
+		return false;
+	}
+
+	return graph.SaveToBinaryFile(binaryFilePath, GetFileStamp(filePath));
+}
+
+uint64 KeypointGraph::GetFileStamp(const std::string& filePath)
+{
+	const FString path = UTF8_TO_TCHAR(filePath.c_str());
+	const int64 fileSize = IFileManager::Get().FileSize(*path);
+
+	if (fileSize < 0)
+	{
+		return 0;
+	}
+
+	const uint64 stamp = static_cast<uint64>(IFileManager::Get().GetTimeStamp(*path).GetTicks()) ^ (static_cast<uint64>(fileSize) * 0x9e3779b97f4a7c15ull);
+
+	return stamp == 0 ? 1 : stamp;
+}
+
+void KeypointGraph::PrepareRouting(const std::string& landmarkFilePath)
+{
+	if (landmarks_.LoadFromFile(landmarkFilePath, *this))
+	{
+		return;
+	}
+
+	landmarks_.Build(*this);
+
+	if (!landmarks_.SaveToFile(landmarkFilePath))
+	{
+		std::cout << "couldn't save routing landmarks to " << landmarkFilePath << std::endl;
+	}
+}
+
 void KeypointGraph::AlignWithWorldGround(UWorld* world)
 {
-	for (Keypoint& keypoint : keypoints_)
+	if (!compactLayoutValid_)
 	{
-		FHitResult outHit;
-		FCollisionShape collisionShape;
+		Freeze();
+	}
 
-		// Sweep with a small box instead of a point to avoid the trace going into
-		// small crevices in the ground e.g. between tram rails
-		collisionShape.ShapeType = ECollisionShape::Box;
-		collisionShape.SetBox(FVector3f(20.0f));
+	FCollisionShape collisionShape;
 
-		if (world->SweepSingleByChannel(outHit,
-			keypoint.position + FVector::UpVector * 100.0f, keypoint.position - FVector::UpVector * 300.0f,
-			FQuat::Identity, ECollisionChannel::ECC_WorldStatic, collisionShape))
+	// Sweep with a small box instead of a point to avoid the trace going into
+	// small crevices in the ground e.g. between tram rails
+	collisionShape.ShapeType = ECollisionShape::Box;
+	collisionShape.SetBox(FVector3f(20.0f));
+
+	// The sweeps are spread across the worker threads while this thread holds the physics scene read lock. The
+	// queries only read the scene, and the lock keeps it from being modified until all of them have finished: the
+	// game thread is the only writer of the scene's external state and it's blocked here waiting for the sweeps.
+	// The engine runs its own async traces on worker threads the same way. The read lock is shared, so the lock
+	// that each query takes again internally doesn't block
+	FPhysicsCommand::ExecuteRead(world->GetPhysicsScene(), [&]()
 		{
-			keypoint.position.Z = outHit.ImpactPoint.Z;
+			ParallelFor(positions_.size(), [&](int32 i)
+				{
+					FVector& position = positions_[i];
+					FHitResult outHit;
+
+					if (world->SweepSingleByChannel(outHit,
+						position + FVector::UpVector * 100.0f, position - FVector::UpVector * 300.0f,
+						FQuat::Identity, ECollisionChannel::ECC_WorldStatic, collisionShape))
+					{
+						position.Z = outHit.ImpactPoint.Z;
+					}
+				});
+		});
+
+	// Only the heights change, so there's no need to freeze the whole graph again
+	if (editableLayoutValid_)
+	{
+		for (int i = 0; i < positions_.size(); i++)
+		{
+			keypoints_[i].position.Z = positions_[i].Z;
 		}
 	}
+
+	groundStamp_ = GetGroundStamp(world);
+}
+
+uint64 KeypointGraph::GetGroundStamp(UWorld* world)
+{
+	auto getPackageStamp = [](const UPackage* package) -> uint64
+		{
+			FString fileName;
+
+			if (package == nullptr || !FPackageName::DoesPackageExist(UWorld::RemovePIEPrefix(package->GetName()), &fileName))
+			{
+				return 0;
+			}
+
+			return GetFileStamp(TCHAR_TO_UTF8(*fileName));
+		};
+
+	const UPackage* levelPackage = world->GetOutermost();
+
+	uint64 stamp = GetTypeHash(UWorld::RemovePIEPrefix(levelPackage->GetName()));
+
+	stamp = stamp * 0x100000001b3ull ^ getPackageStamp(levelPackage);
+
+	// Saving the level or any of its landscapes changes the stamp. With World Partition the landscapes are saved in
+	// their own packages instead of the level package. Summing makes the stamp independent of the iteration order
+	uint64 landscapes = 0;
+
+	for (TActorIterator<ALandscapeProxy> it = TActorIterator<ALandscapeProxy>(world); it; it.operator++())
+	{
+		landscapes += (GetTypeHash(it->GetLandscapeGuid()) * 0x9e3779b97f4a7c15ull) ^ getPackageStamp(it->GetExternalPackage());
+	}
+
+	stamp = stamp * 0x100000001b3ull ^ landscapes;
+
+	return stamp == 0 ? 1 : stamp;
 }
 
 void KeypointGraph::ApplyZoneRules(ATrafficController* controller)
@@ -309,13 +829,21 @@ void KeypointGraph::ApplyZoneRules(ATrafficController* controller)
 	{
 		return;
 	}
-	for (Keypoint& keypoint : keypoints_)
+	if (!compactLayoutValid_)
 	{
-		int32 zoneRules = controller->GetKeypointRegulationRulesAtPoint(keypoint.position);
-		keypoint.rules = keypoint.rules | zoneRules;
+		Freeze();
 	}
 
-	return;
+	for (int i = 0; i < rules_.size(); i++)
+	{
+		int32 zoneRules = controller->GetKeypointRegulationRulesAtPoint(positions_[i]);
+		rules_[i] = rules_[i] | zoneRules;
+
+		if (editableLayoutValid_)
+		{
+			keypoints_[i].rules = rules_[i];
+		}
+	}
 }
 
 KeypointPath KeypointGraph::GetRandomPathFrom(const int& startKeypointIndex, const int32 ruleExceptions) const
@@ -345,14 +873,32 @@ KeypointPath KeypointGraph::GetRandomPathFrom(const int& startKeypointIndex, con
 
 	while (kps.Num() < RANDOM_PATH_MAX_LENGTH)
 	{
-		std::vector<int> nexts = GetVerifiedKeypoints(keypoints_[last].outboundKeypoints, ruleExceptions);
+		const std::span<const int> outbounds = GetOutBoundKeypoints(last);
 
-		if (nexts.size() == 0)
+		int validCount = 0;
+
+		for (const int& outbound : outbounds)
+		{
+			validCount += CompareRules(outbound, ruleExceptions) ? 1 : 0;
+		}
+
+		if (validCount == 0)
 		{
 			break;
 		}
 
-		const int next = nexts[FMath::RandRange(0, nexts.size() - 1)];
+		// Pick a random keypoint out of the valid ones without collecting them anywhere
+		int nth = FMath::RandRange(0, validCount - 1);
+		int next = -1;
+
+		for (const int& outbound : outbounds)
+		{
+			if (CompareRules(outbound, ruleExceptions) && nth-- == 0)
+			{
+				next = outbound;
+				break;
+			}
+		}
 
 		kps.Add(next);
 		last = next;
@@ -369,123 +915,67 @@ KeypointPath KeypointGraph::FindPath(const int& startKeypointIndex, const int& d
 		return GetRandomPath();
 	}
 
-	// This is a basic A* algorithm, from here on out
-	// Structure to store nodes
-	struct KPNode
-	{
-		KPNode(KPNode* p, int k, float w)
-		{
-			parent = p;
-			keypoint = k;
-			weight = w;
-		}
-		float weight = -1;
-		KPNode* parent = nullptr;
-		int keypoint;
-	};
+	// A* with the straight-line distance to the destination or the landmark bound, whichever is larger, as the
+	// heuristic. Links are weighted by their 2D length, so the heuristic never overestimates and every keypoint
+	// is expanded at most once
+	PathSearchScratch& scratch = pathSearchScratch;
 
-	TArray< KPNode* > closed;
-	TArray< KPNode* > opened;
-	KPNode* start = new KPNode(nullptr, startKeypointIndex, 0);
-	opened.Add(start);
+	scratch.Begin(KeypointCount());
 
-	while (opened.Num() > 0)
+	if (destination >= 0 && destination < KeypointCount())
 	{
-		KPNode* q = nullptr;
-		float w = -1;
+		scratch.Open(startKeypointIndex, -1, 0.0f, EstimateRouteLength(startKeypointIndex, destination));
+	}
 
-		for (KPNode* kpn : opened)
+	while (!scratch.open.empty())
+	{
+		std::pop_heap(scratch.open.begin(), scratch.open.end(), std::greater<>());
+		const int q = scratch.open.back().second;
+		scratch.open.pop_back();
+
+		// The same keypoint may have been queued several times with decreasing costs
+		if (scratch.IsClosed(q))
 		{
-			if (q == nullptr || kpn->weight < w)
-			{
-				w = kpn->weight;
-				q = kpn;
-			}
+			continue;
 		}
 
-		opened.Remove(q);
+		scratch.Close(q);
 
-		// Check rules. Only open those keypoints that are accessible by current entity rules
-		std::vector<int> validOutbound = GetVerifiedKeypoints(keypoints_[q->keypoint].outboundKeypoints, ruleExceptions);
-
-		for (int kpi : validOutbound)
+		if (q == destination && q != startKeypointIndex)
 		{
-			Keypoint kp = keypoints_[kpi];
-			float childWeight = q->weight + FVector::Dist2D(keypoints_[q->keypoint].position, kp.position);
+			TArray<int> kps;
 
-			// Additional checks
-			bool cont = true;
-			for (KPNode* check : opened)
+			for (int kp = q; kp != -1; kp = scratch.parent[kp])
 			{
-				if (check->keypoint == kpi && check->weight < childWeight)
-				{
-					cont = false;
-					break;
-				}
+				kps.Add(kp);
 			}
 
-			if (!cont)
-			{
-				break;
-			}
+			Algo::Reverse(kps);
 
-			for (KPNode* check : closed)
-			{
-				if (check->keypoint == kpi && check->weight < childWeight)
-				{
-					cont = false;
-					break;
-				}
-			}
+			return { this, kps };
+		}
 
-			if (!cont)
+		const FVector& position = positions_[q];
+
+		for (const int& kpi : GetOutBoundKeypoints(q))
+		{
+			// Check rules. Only open those keypoints that are accessible by current entity rules
+			if (scratch.IsClosed(kpi) || !CompareRules(kpi, ruleExceptions))
 			{
-				break;
+				continue;
 			}
 
-			KPNode* child = new KPNode(q, kpi, childWeight);
-			opened.Add(child);
+			const float childCost = scratch.cost[q] + FVector::Dist2D(position, positions_[kpi]);
 
-			// Destination found?
-			if (kpi == destination)
+			if (!scratch.IsReached(kpi) || childCost < scratch.cost[kpi])
 			{
-				// Flip & return shortest keypoint path from destination to start
-				TArray<int> kps;
-				KPNode* r = child;
-
-				// Get parent refs all the way to start node
-				while (r->parent != nullptr)
-				{
-					kps.Add(r->keypoint);
-					r = r->parent;
-				}
-
-				kps.Add(startKeypointIndex);
-				TArray<int> kpsr;
-
-				// Reverse keypoint array
-				for (int i = kps.Num() - 1; i >= 0; i--)
-				{
-					kpsr.Add(kps[i]);
-				}
-
-				// Clear references
-				opened.Empty();
-				closed.Empty();
-
-				return { this, kpsr };
+				scratch.Open(kpi, q, childCost, childCost + EstimateRouteLength(kpi, destination));
 			}
 		}
-
-		closed.Add(q);
 	}
-// Clear references
-	opened.Empty();
-	closed.Empty();
-
 
 // A path could not be found, give path to a random outbound keypoint if there are any. Otherwise just spawn the vehicle again from a spawn point.
-	std::vector<int> outbounds = GetVerifiedKeypoints(keypoints_[startKeypointIndex].outboundKeypoints, ruleExceptions);
+	std::vector<int> outbounds = GetVerifiedKeypoints(GetOutBoundKeypoints(startKeypointIndex), ruleExceptions);
 	if (outbounds.size() == 0)
 	{
 		return GetRandomPathFrom(GetRandomSpawnPoint());
@@ -502,10 +992,10 @@ std::vector<int> KeypointGraph::GetKeypointsWithMargin(const float& margin) cons
 	float marginSquared = margin * margin;
 	std::vector<int> result;
 
-	result.reserve(keypoints_.size());
+	result.reserve(positions_.size());
 
 	//Randomize keypoint order, so we don't always end up with the same set of keypoints
-	std::vector<Keypoint> randOrderKeypoints = std::vector<Keypoint>(keypoints_);
+	std::vector<FVector> randOrderKeypoints = std::vector<FVector>(positions_);
 	auto rd = std::random_device{};
 	auto rng = std::default_random_engine{ rd() };
 	std::shuffle(std::begin(randOrderKeypoints), std::end(randOrderKeypoints), rng);
@@ -518,7 +1008,7 @@ std::vector<int> KeypointGraph::GetKeypointsWithMargin(const float& margin) cons
 		for (int j = 0; j < result.size(); j++)
 		{
 			// Using squared vector lengths is slightly faster and doesn't change the results
-			if ((randOrderKeypoints[i].position - randOrderKeypoints[result[j]].position).SizeSquared() < marginSquared)
+			if ((randOrderKeypoints[i] - randOrderKeypoints[result[j]]).SizeSquared() < marginSquared)
 			{
 				otherKeypointsWithinMargin = true;
 				break;
@@ -560,9 +1050,11 @@ FRotator KeypointGraph::GetKeypointRotation(const int& keypointIndex) const
 
 	FVector directionVector = FVector::ZeroVector;
 
-	for (const int& outboundKeypoint : keypoints_[keypointIndex].outboundKeypoints)
+	const std::span<const int> outbounds = GetOutBoundKeypoints(keypointIndex);
+
+	for (const int& outboundKeypoint : outbounds)
 	{
-		directionVector += keypoints_[outboundKeypoint].position / keypoints_[keypointIndex].outboundKeypoints.size();
+		directionVector += positions_[outboundKeypoint] / outbounds.size();
 	}
 
 	return directionVector.ToOrientationRotator();
@@ -570,17 +1062,17 @@ FRotator KeypointGraph::GetKeypointRotation(const int& keypointIndex) const
 
 int KeypointGraph::GetClosestKeypoint(const FVector& position) const
 {
-	if (keypoints_.size() == 0)
+	if (positions_.size() == 0)
 	{
 		return -1;
 	}
 
 	int keypointIndex = 0;
-	float shortestDistance = FVector::DistSquared(position, keypoints_[0].position);
+	float shortestDistance = FVector::DistSquared(position, positions_[0]);
 
-	for (int i = 1; i < keypoints_.size(); i++)
+	for (int i = 1; i < positions_.size(); i++)
 	{
-		float currDist = FVector::DistSquared(position, keypoints_[i].position);
+		float currDist = FVector::DistSquared(position, positions_[i]);
 
 		if (currDist <= shortestDistance)
 		{
@@ -600,12 +1092,13 @@ bool KeypointGraph::CompareRules(const Keypoint& keypoint, const int32 exception
 
 bool KeypointGraph::CompareRules(const int keypointIndex, const int32 exceptions) const
 {
-	if (keypointIndex >= keypoints_.size())
+	if (keypointIndex >= rules_.size())
 	{
 		return false;
 	}
 
-	return CompareRules(keypoints_[keypointIndex], exceptions);
+	// Compare bits in keypoint rules & given rule exceptions.
+	return (rules_[keypointIndex] & exceptions) == rules_[keypointIndex];
 }
 
 std::vector<Keypoint*> KeypointGraph::GetKeypointsByRules(std::vector<Keypoint>& from, const int32 exceptions)
@@ -645,9 +1138,9 @@ void KeypointGraph::UpdateEntryPoints()
 {
 	entryPoints_.clear();
 
-	for (int i = 0; i < keypoints_.size(); i++)
+	for (int i = 0; i < KeypointCount(); i++)
 	{
-		if (keypoints_[i].inboundKeypoints.size() == 0)
+		if (GetInboundKeypoints(i).size() == 0)
 		{
 			entryPoints_.push_back(i);
 		}
@@ -665,7 +1158,7 @@ void KeypointGraph::VerifyKeypoints(std::vector<int>& keypoints, const int32 rul
 	}	
 }
 
-std::vector<int> KeypointGraph::GetVerifiedKeypoints(std::vector<int> keypoints, const int32 ruleExceptions) const
+std::vector<int> KeypointGraph::GetVerifiedKeypoints(std::span<const int> keypoints, const int32 ruleExceptions) const
 {
 	std::vector<int> ret;
 	ret.reserve(keypoints.size());
@@ -3,10 +3,13 @@
 #include "Math/Vector.h"
 #include "Containers/Array.h"
 #include "Math/UnrealMathUtility.h"
+#include "LaneOccupancy.h"
+#include "RouteLandmarks.h"
 
 #include <random>
 #include <vector>
 #include <string>
+#include <span>
 
 class KeypointGraph;
 class ATrafficController;
@@ -57,7 +60,9 @@ struct Keypoint
 	int32 rules;
 };
 
-// Represents a generic graph made of keypoints connected by links. Can be saved to and loaded from files. Used for traffic entity paths
+// Represents a generic graph made of keypoints connected by links. Can be saved to and loaded from files. Used for traffic entity paths.
+// The keypoints are edited in a flexible layout and then frozen into a compact read-only layout that all of the queries use.
+// Graphs loaded from binary files only have the compact layout until they're edited
 class KeypointGraph
 {
 public:
@@ -71,10 +76,37 @@ public:
 	void SetKeypointRules(const int& kpIndex, const int32& rules);
 	void ClearKeypoints();
 
+	// Rebuilds the compact layout from the edited keypoints. Must be called after editing the graph before it's
+	// used for anything else than saving it. Loading, aligning with the ground and applying zone rules do this automatically
+	void Freeze();
+
 	bool SaveToFile(const std::string& filePath);
 	bool LoadFromFile(const std::string& filePath);
 
+	// The binary format stores the compact layout as is, see KeypointGraphContainer. sourceStamp identifies the text
+	// file the graph came from, loading fails if it's not 0 and doesn't match the stamp stored in the file
+	bool SaveToBinaryFile(const std::string& filePath, const uint64& sourceStamp = 0);
+	bool LoadFromBinaryFile(const std::string& filePath, const uint64& sourceStamp = 0);
+
+	// Loads the graph from the binary file if it was converted from the current version of the text file. Otherwise
+	// loads the text file and converts it to the binary file for next time. If a world is given, the graph is also
+	// aligned with its ground and the aligned heights are cached in the binary file until the ground changes
+	bool LoadFromFileCached(const std::string& filePath, const std::string& binaryFilePath, UWorld* world = nullptr);
+
+	static bool ConvertToBinaryFile(const std::string& filePath, const std::string& binaryFilePath);
+
+	// Changes whenever the file is modified, 0 if the file doesn't exist
+	static uint64 GetFileStamp(const std::string& filePath);
+
+	// Loads the landmarks used to speed up FindPath from the given file. If the file is missing or was made for a
+	// different graph, the landmarks are computed and saved to the file instead
+	void PrepareRouting(const std::string& landmarkFilePath);
+
+	// Traces the ground under every keypoint. This is slow for big graphs, consider LoadFromFileCached instead
 	void AlignWithWorldGround(UWorld* world);
+
+	// Identifies the level and the version of its landscapes. Changes whenever either of them is saved
+	static uint64 GetGroundStamp(UWorld* world);
 	void ApplyZoneRules(ATrafficController* controller);
 
 	// Get random paths. Only allow paths that comply with given rule exceptions. All rules bypassed by default.
@@ -89,45 +121,51 @@ public:
 	// Remove keypoints from a list if they are too close to a position
 	void RemoveKeypointsByRange(std::vector<int>& list, const FVector2D position, float range);
 
-	inline int KeypointCount() const { return keypoints_.size(); };
+	inline int KeypointCount() const { return positions_.size(); };
 
 	/**
 	*	Note, that if relevant, you should use KeypointPath::GetPointPosition instead
 	*   i.e. if an entity has custom (key)points, you need to use that
 	*	@see KeypointPath, KeypointPath::GetPointPosition
 	*/
-	inline FVector GetKeypointPosition(const int& keypointIndex) const { return keypointIndex > KeypointCount() - 1 ? FVector() : keypoints_[keypointIndex].position; };
+	inline FVector GetKeypointPosition(const int& keypointIndex) const { return keypointIndex > KeypointCount() - 1 ? FVector() : positions_[keypointIndex]; };
 	FRotator GetKeypointRotation(const int& keypointIndex) const;
 	int GetClosestKeypoint(const FVector& position) const;
 
-	inline int LinkCount() const { return links_.size(); };
-	inline std::pair<int, int> GetLinkKeypoints(const int& linkIndex) const { return links_[linkIndex]; };
+	// The links are read from the compact layout if the editable layout hasn't been built, e.g. after a binary load
+	inline int LinkCount() const { return editableLayoutValid_ ? links_.size() : outbound_.size(); };
+	std::pair<int, int> GetLinkKeypoints(const int& linkIndex) const;
 
 	inline int SpawnPointCount() const { return spawnPoints_.size(); };
 	inline int GetSpawnPoint(const int& spawnPointIndex) const { return spawnPoints_[spawnPointIndex]; };
 	inline int GetRandomSpawnPoint() const { return spawnPoints_[FMath::RandRange(0, SpawnPointCount() - 1)]; };
 
-	std::vector<int> GetInboundKeypoints(const int keypointIndex) const { return (keypointIndex >= 0 && keypointIndex < keypoints_.size()) ? keypoints_[keypointIndex].inboundKeypoints : std::vector<int>(); }
-	std::vector<int> GetOutBoundKeypoints(const int keypointIndex) const { return (keypointIndex >= 0 && keypointIndex < keypoints_.size()) ? keypoints_[keypointIndex].outboundKeypoints : std::vector<int>(); }
+	// The returned spans stay valid until the graph is frozen again
+	std::span<const int> GetInboundKeypoints(const int keypointIndex) const { return (keypointIndex >= 0 && keypointIndex < KeypointCount()) ? std::span<const int>(inbound_.data() + inboundStarts_[keypointIndex], inbound_.data() + inboundStarts_[keypointIndex + 1]) : std::span<const int>(); }
+	std::span<const int> GetOutBoundKeypoints(const int keypointIndex) const { return (keypointIndex >= 0 && keypointIndex < KeypointCount()) ? std::span<const int>(outbound_.data() + outboundStarts_[keypointIndex], outbound_.data() + outboundStarts_[keypointIndex + 1]) : std::span<const int>(); }
 
 	// Methods for getting & comparing keypoint rules
-	int32 GetKeypointRules(const int keypointIndex) const { return keypoints_[keypointIndex].rules; }
+	int32 GetKeypointRules(const int keypointIndex) const { return rules_[keypointIndex]; }
 	bool CompareRules(const Keypoint& keypoint, const int32 exceptions) const;
 	bool CompareRules(const int keypointIndex, const int32 exceptions) const;
 	// Find keypoints containing rules
 	std::vector<Keypoint*> GetKeypointsByRules(std::vector<Keypoint>& from, const int32 exceptions);
-	std::vector<Keypoint*> GetKeypointsByRules(const int32 exceptions) { return GetKeypointsByRules(keypoints_, exceptions); };
+	std::vector<Keypoint*> GetKeypointsByRules(const int32 exceptions) { UpdateEditableLayout(); return GetKeypointsByRules(keypoints_, exceptions); };
 
 	/* If the given lane allows it, return the lane that is paired with the given lane for overtaking.
 	if allowBothWays is true, overtaking from left lane to right is allowed. Returns (-1, -1) if overtaking not allowed in given lane */
 	std::pair<int, int> GetOvertakePair(std::pair<int, int> currentLane, bool allowBothWays) const;
 	std::vector< std::pair<std::pair<int, int>, std::pair<int, int>> > GetOvertakes() const { return overtakes_; };
 
+	// Which entities are on each link right now. Entities only hold const references to the graph, so this is mutable
+	inline LaneOccupancy& GetLaneOccupancy() const { return laneOccupancy_; }
+
 protected:
 
 	using Link = std::pair<int, int>;
 	using OvertakeLaneLink = std::pair<std::pair<int, int>, std::pair<int, int>>;
 
+	// Editable layout
 	std::vector<Keypoint> keypoints_;
 	std::vector<Link> links_;
 	std::vector<OvertakeLaneLink> overtakes_;
@@ -135,10 +173,38 @@ protected:
 	std::vector<int> entryPoints_;
 	std::vector<int> spawnPoints_;
 
+	// Whether each layout matches the current state of the graph. At least one of them always does
+	bool editableLayoutValid_ = true;
+	bool compactLayoutValid_ = true;
+
+	// See KeypointGraphContainer::FileHeader::groundStamp
+	uint64 groundStamp_ = 0;
+
+	mutable LaneOccupancy laneOccupancy_;
+
+	RouteLandmarks landmarks_;
+
+	// Compact layout built by Freeze. The outbound keypoints of keypoint i are outbound_[outboundStarts_[i]] to
+	// outbound_[outboundStarts_[i + 1] - 1] and the inbound keypoints are stored the same way
+	std::vector<FVector> positions_;
+	std::vector<int32> rules_;
+	std::vector<int> outboundStarts_;
+	std::vector<int> outbound_;
+	std::vector<int> inboundStarts_;
+	std::vector<int> inbound_;
+
 	void UpdateEntryPoints();
 
+	// Rebuilds the editable layout from the compact layout if the graph was loaded from a binary file
+	void UpdateEditableLayout();
+	// Must be called before editing the graph
+	void Thaw();
+
+	// Never overestimates the length of the shortest route between the keypoints
+	inline float EstimateRouteLength(const int& from, const int& to) const { return FMath::Max<float>(FVector::Dist2D(positions_[from], positions_[to]), landmarks_.GetLowerBound(from, to)); }
+
 	// Remove any illegal keypoints from given list. Use this when comparing rules with a list of keypoints.
 	void VerifyKeypoints(std::vector<int>& keypoints, const int32 ruleExceptions);
 	// Same except returns a new list of keypoints
-	std::vector<int> GetVerifiedKeypoints(std::vector<int> keypoints, const int32 ruleExceptions) const;
+	std::vector<int> GetVerifiedKeypoints(std::span<const int> keypoints, const int32 ruleExceptions) const;
 };
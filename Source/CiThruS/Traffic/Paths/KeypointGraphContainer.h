@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+// Layout of the binary keypoint graph files written by KeypointGraph::SaveToBinaryFile. All values are little endian.
+//
+// The file starts with a FileHeader, followed by these arrays in order without any padding:
+// keypointCount Positions, keypointCount rules, keypointCount + 1 outbound starts, outboundCount outbound keypoints,
+// keypointCount + 1 inbound starts, inboundCount inbound keypoints, spawnPointCount spawn points and overtakeCount
+// Overtakes. Apart from the positions, everything is an int32_t. The arrays are the compact layout of KeypointGraph
+// as is, so they can be used straight from a memory mapping without parsing anything
+namespace KeypointGraphContainer
+{
+	constexpr uint32_t FILE_MAGIC = 0x474b5443; // "CTKG"
+	constexpr uint32_t VERSION = 1;
+
+#pragma pack(push, 1)
+	struct FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+
+		// Identifies the version of the text file the graph was converted from, 0 if unknown
+		uint64_t sourceStamp;
+
+		// Identifies the ground the keypoint heights have been aligned with, 0 if they haven't been aligned
+		uint64_t groundStamp;
+
+		uint32_t keypointCount;
+		uint32_t outboundCount;
+		uint32_t inboundCount;
+		uint32_t spawnPointCount;
+		uint32_t overtakeCount;
+
+		// Keeps the positions after the header 8-byte aligned
+		uint32_t reserved;
+	};
+
+	struct Position
+	{
+		double x;
+		double y;
+		double z;
+	};
+
+	// Right lane start and end, then left lane start and end
+	struct Overtake
+	{
+		int32_t lane1Start;
+		int32_t lane1End;
+		int32_t lane2Start;
+		int32_t lane2End;
+	};
+#pragma pack(pop)
+
+	static_assert(sizeof(FileHeader) % 8 == 0);
+}
@@ -29,7 +29,7 @@ struct FKeypointToolKP
 	UPROPERTY(BlueprintReadWrite)
 		int32 rules;
 
-	FKeypointToolKP(int newId = 0, FVector newLocation = FVector(0,0,0), std::vector<int> newOutbound = std::vector<int>(), std::vector<int> newInbound = std::vector<int>(), int32 newRules = 0)
+	FKeypointToolKP(int newId = 0, FVector newLocation = FVector(0,0,0), std::span<const int> newOutbound = std::span<const int>(), std::span<const int> newInbound = std::span<const int>(), int32 newRules = 0)
 	{
 		id = newId;
 		location = newLocation;
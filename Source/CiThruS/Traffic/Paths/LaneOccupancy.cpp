@@ -0,0 +1,173 @@
+#include "LaneOccupancy.h"
+
+#include <algorithm>
+
+LaneOccupancy::Handle LaneOccupancy::Update(const Handle& handle, AActor* entity, const int& from, const int& to, const float& linkLength, const float& distance)
+{
+	const int32 lane = GetLane(from, to);
+
+	lanes_[lane].length = linkLength;
+
+	if (!IsOnLink(handle, entity))
+	{
+		Handle newHandle;
+
+		if (freeHandles_.empty())
+		{
+			newHandle = occupants_.size();
+			occupants_.push_back(Occupant());
+		}
+		else
+		{
+			newHandle = freeHandles_.back();
+			freeHandles_.pop_back();
+		}
+
+		occupants_[newHandle] = { entity, lane, 0, distance };
+
+		Insert(newHandle);
+
+		return newHandle;
+	}
+
+	Occupant& occupant = occupants_[handle];
+
+	if (occupant.lane != lane)
+	{
+		Remove(handle);
+
+		occupant.lane = lane;
+		occupant.distance = distance;
+
+		Insert(handle);
+
+		return handle;
+	}
+
+	occupant.distance = distance;
+
+	// Entities rarely pass each other on the same link, so usually the entity is still in the right slot
+	Lane& currentLane = lanes_[lane];
+
+	while (occupant.slot + 1 < currentLane.occupants.size() && occupants_[currentLane.occupants[occupant.slot + 1]].distance < distance)
+	{
+		Swap(currentLane, occupant.slot, occupant.slot + 1);
+	}
+
+	while (occupant.slot > 0 && occupants_[currentLane.occupants[occupant.slot - 1]].distance > distance)
+	{
+		Swap(currentLane, occupant.slot, occupant.slot - 1);
+	}
+
+	return handle;
+}
+
+void LaneOccupancy::Leave(const Handle& handle, AActor* entity)
+{
+	if (!IsOnLink(handle, entity))
+	{
+		return;
+	}
+
+	Remove(handle);
+
+	occupants_[handle].entity = nullptr;
+	freeHandles_.push_back(handle);
+}
+
+void LaneOccupancy::Clear()
+{
+	occupants_.clear();
+	freeHandles_.clear();
+	lanes_.clear();
+	laneIndices_.clear();
+}
+
+AActor* LaneOccupancy::GetLeader(const Handle& handle, AActor* entity, const int& nextTo, float& gap) const
+{
+	if (!IsOnLink(handle, entity))
+	{
+		return nullptr;
+	}
+
+	const Occupant& occupant = occupants_[handle];
+	const Lane& lane = lanes_[occupant.lane];
+
+	if (occupant.slot + 1 < lane.occupants.size())
+	{
+		const Occupant& leader = occupants_[lane.occupants[occupant.slot + 1]];
+
+		gap = leader.distance - occupant.distance;
+
+		return leader.entity;
+	}
+
+	if (nextTo < 0)
+	{
+		return nullptr;
+	}
+
+	// Nobody else ahead on this link, the leader is the entity that has travelled the least on the next link
+	auto nextLane = laneIndices_.find(GetLinkKey(lane.to, nextTo));
+
+	if (nextLane == laneIndices_.end() || lanes_[nextLane->second].occupants.empty())
+	{
+		return nullptr;
+	}
+
+	const Occupant& leader = occupants_[lanes_[nextLane->second].occupants.front()];
+
+	gap = lane.length - occupant.distance + leader.distance;
+
+	return leader.entity;
+}
+
+int32 LaneOccupancy::GetLane(const int& from, const int& to)
+{
+	auto result = laneIndices_.try_emplace(GetLinkKey(from, to), static_cast<int32>(lanes_.size()));
+
+	if (result.second)
+	{
+		lanes_.push_back({ from, to, 0.0f });
+	}
+
+	return result.first->second;
+}
+
+void LaneOccupancy::Insert(const Handle& handle)
+{
+	Occupant& occupant = occupants_[handle];
+	Lane& lane = lanes_[occupant.lane];
+
+	auto it = std::upper_bound(lane.occupants.begin(), lane.occupants.end(), occupant.distance,
+		[this](const float& distance, const Handle& other) { return distance < occupants_[other].distance; });
+
+	occupant.slot = it - lane.occupants.begin();
+	lane.occupants.insert(it, handle);
+
+	for (int32 i = occupant.slot + 1; i < lane.occupants.size(); i++)
+	{
+		occupants_[lane.occupants[i]].slot = i;
+	}
+}
+
+void LaneOccupancy::Remove(const Handle& handle)
+{
+	const Occupant& occupant = occupants_[handle];
+	Lane& lane = lanes_[occupant.lane];
+
+	lane.occupants.erase(lane.occupants.begin() + occupant.slot);
+
+	for (int32 i = occupant.slot; i < lane.occupants.size(); i++)
+	{
+		occupants_[lane.occupants[i]].slot = i;
+	}
+}
+
+void LaneOccupancy::Swap(Lane& lane, const int32& slotA, const int32& slotB)
+{
+	std::swap(lane.occupants[slotA], lane.occupants[slotB]);
+
+	occupants_[lane.occupants[slotA]].slot = slotA;
+	occupants_[lane.occupants[slotB]].slot = slotB;
+}
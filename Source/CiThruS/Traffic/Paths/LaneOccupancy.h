@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <vector>
+#include <unordered_map>
+
+class AActor;
+
+// Keeps track of which entities are on each link of a KeypointGraph, sorted by how far along the link they are.
+// The lists are updated incrementally as the entities move, so the entity directly ahead of another on the same
+// lane can be found in constant time
+class LaneOccupancy
+{
+public:
+	using Handle = int32;
+
+	static constexpr Handle INVALID_HANDLE = -1;
+
+	// Places the entity on the link from keypoint from to keypoint to at the given distance from the start of the
+	// link. The entity is moved if it was already on some link. Returns the handle to use for the entity from now on
+	Handle Update(const Handle& handle, AActor* entity, const int& from, const int& to, const float& linkLength, const float& distance);
+
+	// Removes the entity from its link. Does nothing if the handle doesn't belong to the entity anymore
+	void Leave(const Handle& handle, AActor* entity);
+
+	void Clear();
+
+	// Returns the nearest entity ahead of the given entity on its link. If there is nobody ahead on the same link,
+	// returns the entity that has travelled the least on the link from the end of the entity's link to keypoint
+	// nextTo. gap is the distance between the positions of the entities along the links. Returns nullptr if there
+	// is nobody ahead
+	AActor* GetLeader(const Handle& handle, AActor* entity, const int& nextTo, float& gap) const;
+
+	inline bool IsOnLink(const Handle& handle, AActor* entity) const { return handle >= 0 && handle < occupants_.size() && occupants_[handle].entity == entity; }
+
+protected:
+	struct Occupant
+	{
+		AActor* entity;
+		int32 lane;
+
+		// Index in the occupant list of the lane
+		int32 slot;
+		float distance;
+	};
+
+	struct Lane
+	{
+		int from;
+		int to;
+		float length;
+
+		// Sorted by distance, the entity that has travelled the furthest is last
+		std::vector<Handle> occupants;
+	};
+
+	std::vector<Occupant> occupants_;
+	std::vector<Handle> freeHandles_;
+
+	std::vector<Lane> lanes_;
+	std::unordered_map<uint64, int32> laneIndices_;
+
+	static inline uint64 GetLinkKey(const int& from, const int& to) { return (static_cast<uint64>(static_cast<uint32>(from)) << 32) | static_cast<uint32>(to); }
+
+	int32 GetLane(const int& from, const int& to);
+
+	void Insert(const Handle& handle);
+	void Remove(const Handle& handle);
+	void Swap(Lane& lane, const int32& slotA, const int32& slotB);
+};
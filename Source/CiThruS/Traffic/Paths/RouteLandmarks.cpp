@@ -0,0 +1,297 @@
+#include "RouteLandmarks.h"
+#include "KeypointGraph.h"
+
+#include <fstream>
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <cmath>
+
+namespace
+{
+	constexpr float UNREACHABLE = std::numeric_limits<float>::infinity();
+
+	template <typename T>
+	inline void HashValue(uint64& hash, const T& value)
+	{
+		// FNV-1a
+		const uint8* bytes = reinterpret_cast<const uint8*>(&value);
+
+		for (int i = 0; i < sizeof(T); i++)
+		{
+			hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+		}
+	}
+
+	template <typename T>
+	inline void WriteValues(std::ofstream& outFile, const T* values, const size_t& count)
+	{
+		outFile.write(reinterpret_cast<const char*>(values), count * sizeof(T));
+	}
+
+	template <typename T>
+	inline bool ReadValues(std::ifstream& inFile, T* values, const size_t& count)
+	{
+		inFile.read(reinterpret_cast<char*>(values), count * sizeof(T));
+
+		return inFile.good();
+	}
+}
+
+void RouteLandmarks::Build(const KeypointGraph& graph, const int& landmarkCount)
+{
+	Clear();
+
+	const int keypointCount = graph.KeypointCount();
+
+	if (keypointCount == 0 || landmarkCount <= 0)
+	{
+		return;
+	}
+
+	// Keypoints without any links would just waste a landmark
+	std::vector<int> candidates;
+	FVector2D centroid = FVector2D::ZeroVector;
+
+	for (int i = 0; i < keypointCount; i++)
+	{
+		if (graph.GetOutBoundKeypoints(i).size() != 0 || graph.GetInboundKeypoints(i).size() != 0)
+		{
+			candidates.push_back(i);
+			centroid += FVector2D(graph.GetKeypointPosition(i));
+		}
+	}
+
+	if (candidates.empty())
+	{
+		return;
+	}
+
+	centroid /= candidates.size();
+
+	// Landmarks work best on the edges of the graph and far away from each other. Start from the keypoint farthest
+	// from the center and then keep picking the keypoint that is farthest from the landmarks picked so far
+	int nextLandmark = *std::max_element(candidates.begin(), candidates.end(), [&](const int& a, const int& b)
+		{
+			return FVector2D::DistSquared(FVector2D(graph.GetKeypointPosition(a)), centroid) < FVector2D::DistSquared(FVector2D(graph.GetKeypointPosition(b)), centroid);
+		});
+
+	const int count = FMath::Min(landmarkCount, static_cast<int>(candidates.size()));
+
+	fromLandmark_.resize(static_cast<size_t>(keypointCount) * count);
+	toLandmark_.resize(static_cast<size_t>(keypointCount) * count);
+
+	std::vector<float> coverage(keypointCount, UNREACHABLE);
+
+	for (int l = 0; l < count; l++)
+	{
+		landmarks_.push_back(nextLandmark);
+
+		ComputeDistances(graph, nextLandmark, false, fromLandmark_, l, count);
+		ComputeDistances(graph, nextLandmark, true, toLandmark_, l, count);
+
+		for (int i = 0; i < keypointCount; i++)
+		{
+			coverage[i] = FMath::Min(coverage[i], FMath::Min(fromLandmark_[i * count + l], toLandmark_[i * count + l]));
+		}
+
+		// Unreachable keypoints have infinite coverage, so other disconnected parts of the graph get landmarks too
+		nextLandmark = *std::max_element(candidates.begin(), candidates.end(), [&](const int& a, const int& b) { return coverage[a] < coverage[b]; });
+	}
+
+	graphSignature_ = GetGraphSignature(graph);
+}
+
+void RouteLandmarks::Clear()
+{
+	landmarks_.clear();
+	fromLandmark_.clear();
+	toLandmark_.clear();
+	graphSignature_ = 0;
+}
+
+bool RouteLandmarks::SaveToFile(const std::string& filePath) const
+{
+	std::ofstream outFile(filePath, std::ios::binary);
+
+	if (!outFile.is_open())
+	{
+		return false;
+	}
+
+	const int32 landmarkCount = landmarks_.size();
+	const int32 keypointCount = landmarkCount == 0 ? 0 : fromLandmark_.size() / landmarkCount;
+
+	WriteValues(outFile, &FILE_MAGIC, 1);
+	WriteValues(outFile, &FILE_VERSION, 1);
+	WriteValues(outFile, &graphSignature_, 1);
+	WriteValues(outFile, &keypointCount, 1);
+	WriteValues(outFile, &landmarkCount, 1);
+	WriteValues(outFile, landmarks_.data(), landmarks_.size());
+	WriteValues(outFile, fromLandmark_.data(), fromLandmark_.size());
+	WriteValues(outFile, toLandmark_.data(), toLandmark_.size());
+
+	return outFile.good();
+}
+
+bool RouteLandmarks::LoadFromFile(const std::string& filePath, const KeypointGraph& graph)
+{
+	Clear();
+
+	std::ifstream inFile(filePath, std::ios::binary);
+
+	if (!inFile.is_open())
+	{
+		return false;
+	}
+
+	uint32 magic;
+	uint32 version;
+	uint64 signature;
+	int32 keypointCount;
+	int32 landmarkCount;
+
+	if (!ReadValues(inFile, &magic, 1)
+		|| !ReadValues(inFile, &version, 1)
+		|| !ReadValues(inFile, &signature, 1)
+		|| !ReadValues(inFile, &keypointCount, 1)
+		|| !ReadValues(inFile, &landmarkCount, 1))
+	{
+		return false;
+	}
+
+	// The graph has been edited since the landmarks were computed
+	if (magic != FILE_MAGIC || version != FILE_VERSION || signature != GetGraphSignature(graph)
+		|| keypointCount != graph.KeypointCount() || landmarkCount <= 0 || landmarkCount > keypointCount)
+	{
+		return false;
+	}
+
+	landmarks_.resize(landmarkCount);
+	fromLandmark_.resize(static_cast<size_t>(keypointCount) * landmarkCount);
+	toLandmark_.resize(static_cast<size_t>(keypointCount) * landmarkCount);
+
+	if (!ReadValues(inFile, landmarks_.data(), landmarks_.size())
+		|| !ReadValues(inFile, fromLandmark_.data(), fromLandmark_.size())
+		|| !ReadValues(inFile, toLandmark_.data(), toLandmark_.size()))
+	{
+		Clear();
+
+		return false;
+	}
+
+	graphSignature_ = signature;
+
+	return true;
+}
+
+float RouteLandmarks::GetLowerBound(const int& from, const int& to) const
+{
+	const int landmarkCount = landmarks_.size();
+
+	if (landmarkCount == 0 || from < 0 || to < 0 || from >= fromLandmark_.size() / landmarkCount || to >= fromLandmark_.size() / landmarkCount)
+	{
+		return 0.0f;
+	}
+
+	const float* fromLandmarkToFrom = &fromLandmark_[from * landmarkCount];
+	const float* fromLandmarkToTo = &fromLandmark_[to * landmarkCount];
+	const float* toLandmarkFromFrom = &toLandmark_[from * landmarkCount];
+	const float* toLandmarkFromTo = &toLandmark_[to * landmarkCount];
+
+	float bound = 0.0f;
+
+	for (int l = 0; l < landmarkCount; l++)
+	{
+		// d(L, to) <= d(L, from) + d(from, to)
+		if (std::isfinite(fromLandmarkToFrom[l]) && std::isfinite(fromLandmarkToTo[l]))
+		{
+			bound = FMath::Max(bound, fromLandmarkToTo[l] - fromLandmarkToFrom[l]);
+		}
+
+		// d(from, L) <= d(from, to) + d(to, L)
+		if (std::isfinite(toLandmarkFromFrom[l]) && std::isfinite(toLandmarkFromTo[l]))
+		{
+			bound = FMath::Max(bound, toLandmarkFromFrom[l] - toLandmarkFromTo[l]);
+		}
+	}
+
+	return bound;
+}
+
+uint64 RouteLandmarks::GetGraphSignature(const KeypointGraph& graph)
+{
+	// Heights and rules don't affect the distances, so aligning the graph with the ground or applying zone rules
+	// doesn't invalidate the landmarks
+	uint64 hash = 0xcbf29ce484222325ull;
+
+	const int keypointCount = graph.KeypointCount();
+
+	HashValue(hash, keypointCount);
+
+	for (int i = 0; i < keypointCount; i++)
+	{
+		const FVector position = graph.GetKeypointPosition(i);
+
+		HashValue(hash, static_cast<float>(position.X));
+		HashValue(hash, static_cast<float>(position.Y));
+
+		const std::span<const int> outbounds = graph.GetOutBoundKeypoints(i);
+
+		HashValue(hash, static_cast<int32>(outbounds.size()));
+
+		for (const int& outbound : outbounds)
+		{
+			HashValue(hash, outbound);
+		}
+	}
+
+	return hash;
+}
+
+void RouteLandmarks::ComputeDistances(const KeypointGraph& graph, const int& source, const bool& reverse, std::vector<float>& distances, const int& column, const int& columnCount)
+{
+	const int keypointCount = graph.KeypointCount();
+
+	for (int i = 0; i < keypointCount; i++)
+	{
+		distances[i * columnCount + column] = UNREACHABLE;
+	}
+
+	// Dijkstra, links are weighted by their 2D length like in KeypointGraph::FindPath
+	// <distance, keypoint>, a min-heap
+	std::vector<std::pair<float, int>> open;
+
+	distances[source * columnCount + column] = 0.0f;
+	open.push_back({ 0.0f, source });
+
+	while (!open.empty())
+	{
+		std::pop_heap(open.begin(), open.end(), std::greater<>());
+		const std::pair<float, int> current = open.back();
+		open.pop_back();
+
+		const int q = current.second;
+
+		// The same keypoint may have been queued several times with decreasing distances
+		if (current.first > distances[q * columnCount + column])
+		{
+			continue;
+		}
+
+		const FVector position = graph.GetKeypointPosition(q);
+
+		for (const int& kpi : reverse ? graph.GetInboundKeypoints(q) : graph.GetOutBoundKeypoints(q))
+		{
+			const float distance = current.first + FVector::Dist2D(position, graph.GetKeypointPosition(kpi));
+
+			if (distance < distances[kpi * columnCount + column])
+			{
+				distances[kpi * columnCount + column] = distance;
+
+				open.push_back({ distance, kpi });
+				std::push_heap(open.begin(), open.end(), std::greater<>());
+			}
+		}
+	}
+}
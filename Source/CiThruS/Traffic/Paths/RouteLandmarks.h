@@ -0,0 +1,50 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <vector>
+#include <string>
+
+class KeypointGraph;
+
+// Precomputed shortest distances between a few landmark keypoints and every other keypoint of a KeypointGraph.
+// By the triangle inequality they give a lower bound for the distance between any two keypoints, which is a much
+// tighter A* heuristic than the straight-line distance on road networks (ALT). The distances ignore keypoint rules:
+// rules can only make routes longer, so the bounds stay valid for every entity
+class RouteLandmarks
+{
+public:
+	static constexpr int DEFAULT_LANDMARK_COUNT = 12;
+
+	void Build(const KeypointGraph& graph, const int& landmarkCount = DEFAULT_LANDMARK_COUNT);
+	void Clear();
+
+	// The file is only accepted if it was built from a graph with the same keypoint positions and links
+	bool SaveToFile(const std::string& filePath) const;
+	bool LoadFromFile(const std::string& filePath, const KeypointGraph& graph);
+
+	// Returns a lower bound for the length of the shortest route from keypoint from to keypoint to, or 0 if
+	// nothing is known
+	float GetLowerBound(const int& from, const int& to) const;
+
+	inline bool IsBuilt() const { return !landmarks_.empty(); }
+	inline bool Matches(const KeypointGraph& graph) const { return graphSignature_ == GetGraphSignature(graph); }
+
+protected:
+	static constexpr uint32 FILE_MAGIC = 0x4d4c5443; // "CTLM"
+	static constexpr uint32 FILE_VERSION = 1;
+
+	std::vector<int> landmarks_;
+
+	// Indexed by keypoint * landmark count + landmark, so that the bounds of a keypoint are next to each other
+	std::vector<float> fromLandmark_;
+	std::vector<float> toLandmark_;
+
+	uint64 graphSignature_ = 0;
+
+	static uint64 GetGraphSignature(const KeypointGraph& graph);
+
+	// Writes the shortest distances from the source keypoint to every keypoint into the given landmark column,
+	// following the links backwards if reverse is set
+	static void ComputeDistances(const KeypointGraph& graph, const int& source, const bool& reverse, std::vector<float>& distances, const int& column, const int& columnCount);
+};
@@ -28,6 +28,7 @@ ATrafficController::ATrafficController()
 	: parkingController_(nullptr),
 	lodController_(nullptr),
 	massDeletionInProgress_(false),
+	trafficAreasIndexed_(false),
 	visualizeCollisions_(false)
 {
  	// Set this actor to call Tick() every frame
@@ -44,18 +45,20 @@ void ATrafficController::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Load keypoints
-	roadGraph_.LoadFromFile(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/roadGraph.data")));
-	roadGraph_.AlignWithWorldGround(GetWorld());
+	// Load keypoints and align them with the ground. The text files are converted to binary files on the first run,
+	// which are much faster to load and also store the aligned heights until the level or its landscapes change
+	roadGraph_.LoadFromFileCached(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/roadGraph.data")), TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/roadGraph.bin")), GetWorld());
+
+	if (precomputeRoutes_)
+	{
+		roadGraph_.PrepareRouting(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/roadGraph.landmarks")));
+	}
 	
-	sharedUseGraph_.LoadFromFile(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/sharedUseGraph.data")));
-	sharedUseGraph_.AlignWithWorldGround(GetWorld());
+	sharedUseGraph_.LoadFromFileCached(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/sharedUseGraph.data")), TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/sharedUseGraph.bin")), GetWorld());
 
-	tramwayGraph_.LoadFromFile(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/tramwayTrackGraph.data")));
-	tramwayGraph_.AlignWithWorldGround(GetWorld());
+	tramwayGraph_.LoadFromFileCached(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/tramwayTrackGraph.data")), TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/tramwayTrackGraph.bin")), GetWorld());
 
-	bicycleGraph_.LoadFromFile(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/bicycleGraph.data")));
-	bicycleGraph_.AlignWithWorldGround(GetWorld());
+	bicycleGraph_.LoadFromFileCached(TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/bicycleGraph.data")), TCHAR_TO_UTF8(*(FPaths::ProjectDir() + "/DataFiles/bicycleGraph.bin")), GetWorld());
 
 	// Fetch traffic areas
 	trafficAreas_.Empty();
@@ -68,6 +71,14 @@ void ATrafficController::BeginPlay()
 		}
 	}
 
+	trafficAreasIndexed_ = false;
+	touchedTrafficAreas_.clear();
+
+	// Pawns spawned later need to be registered by whoever spawns them, apart from the pedestrians spawned here
+	registeredPawns_.Empty();
+
+	RegisterExistingPawns();
+
 	// Apply extra rules to car keypoints from VehicleRuleZones, incase they aren't applied manually
 	roadGraph_.ApplyZoneRules(this);
 
@@ -110,6 +121,7 @@ void ATrafficController::Tick(float deltaTime)
 	Super::Tick(deltaTime);
 
 	CheckEntityCollisions();
+	IndexQueryActors();
 
 	if (lodController_ != nullptr)
 	{
@@ -135,54 +147,6 @@ void ATrafficController::Tick(float deltaTime)
 	}
 }
 
-TArray<AActor*> ATrafficController::GetEntitiesInArea(FVector center3d, FVector forward3d, float length, float width)
-{
-	TArray<AActor*> colliding;
-
-	FVector2D center = FVector2D(center3d);
-	FVector2D forward = FVector2D(forward3d);
-	FVector2D right = FVector2D(forward3d.ToOrientationQuat().GetRightVector());
-	FVector2D av = FVector2D(center + 0.5f * (forward * length + right * width));
-	FVector2D bv = FVector2D(center + 0.5f * (forward * length - right * width));
-	FVector2D cv = FVector2D(center + 0.5f * (-forward * length - right * width));
-	FVector2D dv = FVector2D(center + 0.5f * (-forward * length + right * width));
-
-	// Collect current pawns in the scene
-	std::list<APawn*> pawns;
-	for (TActorIterator<APawn> it = TActorIterator<APawn>(GetWorld()); it; it.operator++())
-	{
-		if (*it == nullptr)
-		{
-			continue;
-		}
-
-		pawns.push_back(*it);
-	}
-
-	// Check against cars?
-	for (int i = 0; i < simulatedEntities_.size(); i++)
-	{
-		if (ACar* car = Cast<ACar>(simulatedEntities_[i]))
-		{
-			if (MathUtility::PointInsideRectangle(FVector2D(car->GetActorLocation()), av, bv, cv, dv))
-			{
-				colliding.Add(car);
-			}
-		}
-	}
-
-	// Check against pawns
-	for (APawn* pawn : pawns)
-	{
-		if (MathUtility::PointInsideRectangle(FVector2D(pawn->GetActorLocation()), av, bv, cv, dv))
-		{
-			colliding.Add(pawn);
-		}
-	}
-
-	return colliding;
-}
-
 ACar* ATrafficController::SpawnCar()
 {
 	int spawnPoint = roadGraph_.GetRandomSpawnPoint();
@@ -289,6 +253,9 @@ APedestrian* ATrafficController::SpawnPedestrian(const FVector& position, const
 	else
 	{
 		staticEntities_.push_back(pedestrian);
+
+		// Static pedestrians aren't indexed as traffic entities, but queries for pawns should still find them
+		RegisterPawn(pedestrian);
 	}
 
 	return pedestrian;
@@ -424,9 +391,6 @@ void ATrafficController::InvalidateTrafficEntity(ITrafficEntity* entity)
 {
 	if (entity != nullptr && !massDeletionInProgress_)
 	{
-		// Remove entity from zones
-		EntityZoneDelete(entity->GetCurrentZone(), entity);
-
 		auto it = std::find_if(simulatedEntities_.begin(), simulatedEntities_.end(), [entity](ITrafficEntity* wrapper) { return wrapper == entity; });
 		
 		if (it != simulatedEntities_.end())
@@ -436,6 +400,7 @@ void ATrafficController::InvalidateTrafficEntity(ITrafficEntity* entity)
 				lodController_->RemoveEntity(entity);
 			}
 
+			touchedTrafficAreas_.erase(entity);
 			simulatedEntities_.erase(it);
 		}
 	}
@@ -635,6 +600,7 @@ void ATrafficController::DeleteAllEntitiesOfType()
 			lodController_->RemoveEntity(*it);
 		}
 
+		touchedTrafficAreas_.erase(*it);
 		it = simulatedEntities_.erase(it);
 	}
 
@@ -673,27 +639,33 @@ void ATrafficController::ToggleViewFrustrum()
 
 void ATrafficController::VisualizeGraph(KeypointGraph* graph) const
 {
-	for (int i = 0; i < graph->LinkCount(); i++)
-	{
-		std::pair<int, int> link = graph->GetLinkKeypoints(i);
-
-		FVector direction = (graph->GetKeypointPosition(link.second) - graph->GetKeypointPosition(link.first));
-		direction.Normalize();
-
-		Debug::DrawPersistentLine(
-			GetWorld(),
-			graph->GetKeypointPosition(link.first),
-			graph->GetKeypointPosition(link.second),
-			FColor::Green,
-			15.0f);
-
-		// directional indicator
-		Debug::DrawPersistentLine(
-			GetWorld(),
-			graph->GetKeypointPosition(link.second) - direction * 100,
-			graph->GetKeypointPosition(link.second),
-			FColor::Red,
-			15.f);
+	// Walk the compact layout, which is always there even if the graph was loaded from a binary file
+	for (int from = 0; from < graph->KeypointCount(); from++)
+	{
+		const FVector fromPosition = graph->GetKeypointPosition(from);
+
+		for (const int& to : graph->GetOutBoundKeypoints(from))
+		{
+			const FVector toPosition = graph->GetKeypointPosition(to);
+
+			FVector direction = (toPosition - fromPosition);
+			direction.Normalize();
+
+			Debug::DrawPersistentLine(
+				GetWorld(),
+				fromPosition,
+				toPosition,
+				FColor::Green,
+				15.0f);
+
+			// directional indicator
+			Debug::DrawPersistentLine(
+				GetWorld(),
+				toPosition - direction * 100,
+				toPosition,
+				FColor::Red,
+				15.f);
+		}
 	}
 }
 
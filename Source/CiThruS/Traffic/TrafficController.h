@@ -2,13 +2,15 @@
 
 #include "Paths/KeypointGraph.h"
 #include "Areas/RoadRegulationZone.h"
+#include "CollisionGrid.h"
+#include "CollisionSnapshot.h"
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include <mutex>
 #include <list>
+#include <vector>
 #include <unordered_map>
-#include <unordered_set>
 #include "TrafficController.generated.h"
 
 
@@ -20,6 +22,7 @@ class ITrafficArea;
 class ITrafficEntity;
 class AParkingController;
 class LodController;
+class APawn;
 
 UENUM()
 enum CollisionCheckingEnum
@@ -31,6 +34,21 @@ enum CollisionCheckingEnum
 	CITHRUS_COLLISION_DISABLED					UMETA(DisplayName = "Collision checking disabled")
 };
 
+// Types of actors returned by the spatial queries of the traffic controller
+UENUM(BlueprintType, Meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class ETrafficQueryFilter : uint8
+{
+	None = 0 UMETA(Hidden),
+	Cars = 1 << 0,
+	Trams = 1 << 1,
+	Pedestrians = 1 << 2,
+	Bicycles = 1 << 3,
+	Pawns = 1 << 4,
+	All = Cars | Trams | Pedestrians | Bicycles | Pawns
+};
+
+ENUM_CLASS_FLAGS(ETrafficQueryFilter)
+
 
 // Spawns all traffic entities and simulates them. Static parked cars are not traffic entities and are handled by ParkingController instead
 // There should be only one of these in the environment at a time
@@ -38,6 +56,8 @@ UCLASS()
 class CITHRUS_API ATrafficController : public AActor
 {
 	GENERATED_BODY()
+
+	friend class FTrafficQueryPedestrianTest;
 	
 public:	
 	ATrafficController();
@@ -72,11 +92,28 @@ public:
 	inline const KeypointGraph& GetBicycleGraph() const { return bicycleGraph_; }
 	inline const KeypointGraph& GetTramwayGraph() const { return tramwayGraph_; }
 
+	// Simulated cars and pawns whose position is inside the given rectangle
 	TArray<AActor*> GetEntitiesInArea(FVector center3d, FVector forward3d, float length, float width);
 
-	TArray<TSubclassOf<ACar>> GetTemplateCars() const { return templateCars_; }
+	// Spatial queries over the positions of the simulated entities and the registered pawns as they were during
+	// the latest tick of the traffic controller, so every entity sees the same state regardless of tick order.
+	// results is cleared first so that it can be reused between queries without allocating
+	void QueryRectangle(const FVector& center, const FVector& forward, const float& length, const float& width, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const;
+	void QueryRadius(const FVector& center, const float& radius, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const;
+	// coneAngle is the full opening angle of the cone in degrees
+	void QueryCone(const FVector& origin, const FVector& direction, const float& coneAngle, const float& length, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const;
+	// Finds at most count actors within maxDistance, nearest first
+	void QueryNearest(const FVector& center, const int32& count, const float& maxDistance, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const;
 
-	void EntityChangeZone(std::pair<int, int> currentZone, std::pair<int, int> previousZone, ITrafficEntity* entity);
+	// Pawns present when play begins and the player's pawn are registered automatically. Destroyed pawns are
+	// unregistered automatically
+	UFUNCTION(BlueprintCallable, Category = "Traffic System")
+	void RegisterPawn(APawn* pawn);
+
+	UFUNCTION(BlueprintCallable, Category = "Traffic System")
+	void UnregisterPawn(APawn* pawn);
+
+	TArray<TSubclassOf<ACar>> GetTemplateCars() const { return templateCars_; }
 
 	inline int32 GetKeypointRegulationRulesAtPoint(FVector point) { return GetApplyingRegulationRulesAtPoint(point).rules; }
 	inline float GetRegulatedSpeedAtPoint(FVector point) { return GetApplyingRegulationRulesAtPoint(point).speedLimit; }
@@ -90,10 +127,6 @@ public:
 	inline bool UseEditorViewportCameraForLods() const { return useEditorViewportCamera_; }
 
 protected:
-	std::unordered_map<int64, std::unordered_set<ITrafficEntity*>> entitiesByZone_;
-
-	void EntityZoneDelete(std::pair<int32, int32> currentZone, ITrafficEntity* entity);
-
 	/* Enable disable traffic simulation. */
 	UPROPERTY(EditAnywhere, Category = "Traffic System|Vehicle Simulation")
 	bool simulateTraffic_ = true;
@@ -102,6 +135,10 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "Traffic System|Vehicle Simulation")
 	bool simulateParking_ = true;
 
+	/* Precompute routing landmarks for the road graph to speed up finding routes. They are cached in DataFiles next to the graph. */
+	UPROPERTY(EditAnywhere, Category = "Traffic System|Vehicle Simulation")
+	bool precomputeRoutes_ = true;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Traffic System|Vehicle Simulation")
 	TArray<TSubclassOf<ACar>> templateCars_;
 
@@ -162,6 +199,10 @@ protected:
 	// Used for static entities that are not simulated (spawned with simulate = false)
 	std::vector<ITrafficEntity*> staticEntities_;
 
+	// Broadphase and narrowphase for the zone-based collision checks. Simulated entities come first, followed by static entities
+	CollisionGrid collisionGrid_;
+	CollisionSnapshot collisionSnapshot_;
+
 	bool massDeletionInProgress_;
 
 	KeypointGraph roadGraph_;
@@ -171,6 +212,26 @@ protected:
 
 	TArray<ITrafficArea*> trafficAreas_;
 
+	// Index for the spatial queries, rebuilt every tick. Simulated entities come first, followed by the registered pawns.
+	// The actors are weak pointers because they may be destroyed before the index is rebuilt
+	CollisionGrid queryGrid_;
+	std::vector<TWeakObjectPtr<AActor>> queryActors_;
+	std::vector<FVector2D> queryPositions_;
+	std::vector<ETrafficQueryFilter> queryTypes_;
+
+	TArray<TWeakObjectPtr<APawn>> registeredPawns_;
+
+	// Traffic areas don't move, so they are sorted into their own grid once on the first tick after
+	// they have all set up their collision rectangles
+	CollisionGrid trafficAreaGrid_;
+	std::vector<CollisionRectangle> trafficAreaRectangles_;
+	bool trafficAreasIndexed_;
+
+	// Indices of the traffic areas each entity was touching during the previous tick. The areas must
+	// be updated one more time after the entity leaves them so that they can notice it left
+	std::unordered_map<ITrafficEntity*, std::vector<int32>> touchedTrafficAreas_;
+	std::vector<std::vector<int32>> touchingTrafficAreas_;
+
 	bool visualizeCollisions_;
  
 	UFUNCTION(BlueprintCallable)
@@ -189,6 +250,16 @@ protected:
 
 	void CheckEntityCollisions();
 
+	void IndexTrafficAreas();
+	void UpdateTrafficAreaMembership();
+
+	void RegisterExistingPawns();
+	void IndexQueryActors();
+
+	// Calls callback with the index of every actor of the given types inside the given bounds, in index order
+	template <typename Callback>
+	void ForEachQueryActor(const FBox2D& bounds, const ETrafficQueryFilter& filter, Callback callback) const;
+
 	template <class T>
 	void DeleteAllEntitiesOfType();
 
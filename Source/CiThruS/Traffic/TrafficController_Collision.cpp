@@ -12,22 +12,7 @@
 
 #include <list>
 #include <vector>
-
-void ATrafficController::EntityChangeZone(std::pair<int32, int32> currentZone, std::pair<int32, int32> previousZone, ITrafficEntity* entity)
-{
-	// combine keys for hashing
-	int64 currentZoneKey = currentZone.second + (static_cast<int64>(currentZone.first) << 32);
-	int64 previousZoneKey = previousZone.second + (static_cast<int64>(previousZone.first) << 32);
-	
-	entitiesByZone_[previousZoneKey].erase(entity);
-	entitiesByZone_[currentZoneKey].insert(entity);
-}
-
-void ATrafficController::EntityZoneDelete(std::pair<int32, int32> currentZone, ITrafficEntity* entity)
-{
-	int64 currentZoneKey = currentZone.second + (static_cast<int64>(currentZone.first) << 32);
-	entitiesByZone_[currentZoneKey].erase(entity);
-}
+#include <algorithm>
 
 void ATrafficController::CheckEntityCollisions()
 {
@@ -45,14 +30,7 @@ void ATrafficController::CheckEntityCollisions()
 		playerCollision = CollisionRectangle(box.GetSize(), playerPawn->GetActorLocation(), playerPawn->GetActorQuat());
 	}
 
-	// TODO probably don't do this in a separate loop. Needs synchronization to be combined with ParallelFor
-	for (int i = 0; i < simulatedEntities_.size(); i++)
-	{
-		for (ITrafficArea* trafficArea : trafficAreas_)
-		{
-			trafficArea->UpdateCollisionStatusWithEntity(simulatedEntities_[i]);
-		}
-	}
+	UpdateTrafficAreaMembership();
 
 	// Naively loop through all other entities for every entity
 	auto ProcessAllEntities = [&](int32 i)
@@ -88,50 +66,47 @@ void ATrafficController::CheckEntityCollisions()
 		}
 	};
 
-	// For every entity, check collisions against entities in adjacent zones
-	auto ProcessNearbyEntities = [&](int32 i) 
+	const int32 simulatedEntityCount = simulatedEntities_.size();
+
+	// For every entity, check collisions only against the entities that share a grid cell with it
+	auto ProcessNearbyEntities = [&](int32 i)
 	{
 		ITrafficEntity* entity = simulatedEntities_[i];
 		entity->ClearBlockingCollisions();
 
-		// Check collisions against entities in adjacent zones
-		std::pair<int32, int32> currentZone = entity->GetCurrentZone();
-		for (int32 x = -1; x <= 1; x++)
-		{
-			for (int32 z = -1; z <= 1; z++)
+		collisionGrid_.ForEachCandidate(i, [&](const int32& j)
 			{
-				int64 zoneKey = currentZone.second + z + (static_cast<int64>(currentZone.first + x) << 32);
-				std::unordered_map<int64, std::unordered_set<ITrafficEntity*>>::iterator itr = entitiesByZone_.find(zoneKey);
-
-				if (itr == entitiesByZone_.end())
+				// The entities only need to decide how to react to the entities they're actually overlapping
+				if (collisionSnapshot_.MayBlock(i, j))
 				{
-					continue;
+					entity->UpdateBlockingCollisionWith(j < simulatedEntityCount ? simulatedEntities_[j] : staticEntities_[j - simulatedEntityCount]);
 				}
+			});
 
-				std::unordered_set<ITrafficEntity*> entitiesInZone = itr->second;
-
-				for (auto& zoneEntity : entitiesInZone)
-				{
-					if (zoneEntity == entity)
-					{
-						continue;
-					}
-
-					entity->UpdateBlockingCollisionWith(zoneEntity);
-				}
-			}
-		}
-		
-		for (ITrafficEntity* otherEntity : staticEntities_)
-		{
-			otherEntity->UpdateBlockingCollisionWith(entity);
-		}
-		
 		if (playerPawn)
 		{
 			entity->UpdatePawnCollision(playerCollision);
 		}
 	};
+
+	// Collect the collision rectangles of every entity once and sort the entities into the grid
+	auto BuildCollisionGrid = [&](const bool& parallel)
+	{
+		const int32 entityCount = simulatedEntityCount + staticEntities_.size();
+
+		collisionSnapshot_.Reset(entityCount);
+		collisionGrid_.Reset(entityCount);
+
+		ParallelFor(entityCount, [&](int32 i)
+			{
+				ITrafficEntity* entity = i < simulatedEntityCount ? simulatedEntities_[i] : staticEntities_[i - simulatedEntityCount];
+
+				collisionSnapshot_.SetEntity(i, entity->GetCollisionRectangle(), entity->GetPredictedFutureCollisionRectangle());
+				collisionGrid_.SetBounds(i, collisionSnapshot_.GetBounds(i));
+			}, !parallel);
+
+		collisionGrid_.Build();
+	};
 	
 	switch (collisionCheckingType_)
 	{
@@ -142,6 +117,7 @@ void ATrafficController::CheckEntityCollisions()
 
 	case CITHRUS_COLLISION_ZONES_PAR:
 		//UE_LOG(LogTemp, Warning, TEXT("Doing parallel collision checks with collision zones"));
+		BuildCollisionGrid(true);
 		ParallelFor(simulatedEntities_.size(), ProcessNearbyEntities);
 		break;
 
@@ -154,11 +130,106 @@ void ATrafficController::CheckEntityCollisions()
 		break;
 
 	case CITHRUS_COLLISION_ZONES:
-		//UE_LOG(LogTemp, Warning, TEXT("Doing sequential collision checks for all entities"));
+		//UE_LOG(LogTemp, Warning, TEXT("Doing sequential collision checks with collision zones"));
+		BuildCollisionGrid(false);
 		for (int32 i = 0; i < simulatedEntities_.size(); i++)
 		{
-			ProcessAllEntities(i);
+			ProcessNearbyEntities(i);
 		}
 		break;
 	}
 }
+
+void ATrafficController::IndexTrafficAreas()
+{
+	const int32 areaCount = trafficAreas_.Num();
+
+	trafficAreaRectangles_.resize(areaCount);
+	trafficAreaGrid_.Reset(areaCount);
+
+	for (int32 i = 0; i < areaCount; i++)
+	{
+		trafficAreaRectangles_[i] = trafficAreas_[i]->GetCollisionRectangle();
+		trafficAreaGrid_.SetBounds(i, trafficAreaRectangles_[i].GetFlatBounds());
+	}
+
+	trafficAreaGrid_.Build();
+
+	trafficAreasIndexed_ = true;
+}
+
+void ATrafficController::UpdateTrafficAreaMembership()
+{
+	if (!trafficAreasIndexed_)
+	{
+		IndexTrafficAreas();
+	}
+
+	const int32 simulatedEntityCount = simulatedEntities_.size();
+
+	touchingTrafficAreas_.resize(simulatedEntityCount);
+
+	// Find the areas each entity is touching in parallel. The areas only react to entities touching
+	// them with either their current or future collision rectangle
+	ParallelFor(simulatedEntityCount, [&](int32 i)
+		{
+			const CollisionRectangle collision = simulatedEntities_[i]->GetCollisionRectangle();
+			const CollisionRectangle futureCollision = simulatedEntities_[i]->GetPredictedFutureCollisionRectangle();
+
+			std::vector<int32>& touching = touchingTrafficAreas_[i];
+			touching.clear();
+
+			auto CheckArea = [&](const int32& area)
+			{
+				if (trafficAreaRectangles_[area].IsIntersecting(collision) || trafficAreaRectangles_[area].IsIntersecting(futureCollision))
+				{
+					touching.push_back(area);
+				}
+			};
+
+			trafficAreaGrid_.ForEachOverlapping(collision.GetFlatBounds(), CheckArea);
+			trafficAreaGrid_.ForEachOverlapping(futureCollision.GetFlatBounds(), CheckArea);
+
+			std::sort(touching.begin(), touching.end());
+			touching.erase(std::unique(touching.begin(), touching.end()), touching.end());
+		}, collisionCheckingType_ == CITHRUS_COLLISIONS_NAIVE || collisionCheckingType_ == CITHRUS_COLLISION_ZONES);
+
+	// The areas notify the entities when they enter or leave, so the updates are applied on this thread
+	// in the same order every tick. Updating an area with an entity that neither touches it nor touched
+	// it during the previous tick would do nothing, so those pairs are skipped
+	for (int32 i = 0; i < simulatedEntityCount; i++)
+	{
+		ITrafficEntity* entity = simulatedEntities_[i];
+
+		std::vector<int32>& touched = touchedTrafficAreas_[entity];
+		const std::vector<int32>& touching = touchingTrafficAreas_[i];
+
+		auto touchedIt = touched.begin();
+		auto touchingIt = touching.begin();
+
+		while (touchedIt != touched.end() || touchingIt != touching.end())
+		{
+			int32 area;
+
+			if (touchingIt == touching.end() || (touchedIt != touched.end() && *touchedIt < *touchingIt))
+			{
+				area = *touchedIt++;
+			}
+			else
+			{
+				area = *touchingIt;
+
+				if (touchedIt != touched.end() && *touchedIt == area)
+				{
+					touchedIt++;
+				}
+
+				touchingIt++;
+			}
+
+			trafficAreas_[area]->UpdateCollisionStatusWithEntity(entity);
+		}
+
+		touched = touching;
+	}
+}
@@ -0,0 +1,232 @@
+#include "TrafficController.h"
+#include "Entities/ITrafficEntity.h"
+#include "Entities/Car.h"
+#include "Entities/Pedestrian.h"
+#include "Entities/Bicycle.h"
+#include "Entities/Tram/Tram.h"
+#include "Misc/MathUtility.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "EngineUtils.h"
+
+#include <vector>
+#include <algorithm>
+
+template <typename Callback>
+void ATrafficController::ForEachQueryActor(const FBox2D& bounds, const ETrafficQueryFilter& filter, Callback callback) const
+{
+	// The grid reports the actors in cell order, sort them so that the results don't depend on the grid
+	std::vector<int32> found;
+
+	queryGrid_.ForEachOverlapping(bounds, [&](const int32& i)
+		{
+			if (EnumHasAnyFlags(queryTypes_[i], filter) && queryActors_[i].IsValid())
+			{
+				found.push_back(i);
+			}
+		});
+
+	std::sort(found.begin(), found.end());
+
+	for (const int32& i : found)
+	{
+		callback(i);
+	}
+}
+
+TArray<AActor*> ATrafficController::GetEntitiesInArea(FVector center3d, FVector forward3d, float length, float width)
+{
+	TArray<AActor*> colliding;
+
+	// Pedestrians are pawns too, simulated ones are just indexed as traffic entities instead of registered pawns
+	QueryRectangle(center3d, forward3d, length, width, ETrafficQueryFilter::Cars | ETrafficQueryFilter::Pedestrians | ETrafficQueryFilter::Pawns, colliding);
+
+	return colliding;
+}
+
+void ATrafficController::QueryRectangle(const FVector& center, const FVector& forward, const float& length, const float& width, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const
+{
+	results.Reset();
+
+	const FVector2D center2d = FVector2D(center);
+	const FVector2D forward2d = FVector2D(forward);
+	const FVector2D right2d = FVector2D(forward.ToOrientationQuat().GetRightVector());
+
+	const FVector2D corners[4] =
+	{
+		center2d + 0.5f * (forward2d * length + right2d * width),
+		center2d + 0.5f * (forward2d * length - right2d * width),
+		center2d + 0.5f * (-forward2d * length - right2d * width),
+		center2d + 0.5f * (-forward2d * length + right2d * width)
+	};
+
+	ForEachQueryActor(FBox2D(corners, 4), filter, [&](const int32& i)
+		{
+			if (MathUtility::PointInsideRectangle(queryPositions_[i], corners[0], corners[1], corners[2], corners[3]))
+			{
+				results.Add(queryActors_[i].Get());
+			}
+		});
+}
+
+void ATrafficController::QueryRadius(const FVector& center, const float& radius, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const
+{
+	results.Reset();
+
+	const FVector2D center2d = FVector2D(center);
+
+	ForEachQueryActor(FBox2D(center2d - radius, center2d + radius), filter, [&](const int32& i)
+		{
+			if (FVector2D::DistSquared(queryPositions_[i], center2d) <= radius * radius)
+			{
+				results.Add(queryActors_[i].Get());
+			}
+		});
+}
+
+void ATrafficController::QueryCone(const FVector& origin, const FVector& direction, const float& coneAngle, const float& length, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const
+{
+	results.Reset();
+
+	const FVector2D origin2d = FVector2D(origin);
+	const FVector2D direction2d = FVector2D(direction);
+
+	ForEachQueryActor(FBox2D(origin2d - length, origin2d + length), filter, [&](const int32& i)
+		{
+			if (MathUtility::PointInsideCone(queryPositions_[i], origin2d, direction2d, coneAngle, length))
+			{
+				results.Add(queryActors_[i].Get());
+			}
+		});
+}
+
+void ATrafficController::QueryNearest(const FVector& center, const int32& count, const float& maxDistance, const ETrafficQueryFilter& filter, TArray<AActor*>& results) const
+{
+	results.Reset();
+
+	if (count <= 0)
+	{
+		return;
+	}
+
+	const FVector2D center2d = FVector2D(center);
+
+	// <squared distance, index>, the index breaks ties so that the result doesn't depend on the grid
+	std::vector<std::pair<double, int32>> candidates;
+
+	ForEachQueryActor(FBox2D(center2d - maxDistance, center2d + maxDistance), filter, [&](const int32& i)
+		{
+			const double distanceSquared = FVector2D::DistSquared(queryPositions_[i], center2d);
+
+			if (distanceSquared <= maxDistance * maxDistance)
+			{
+				candidates.push_back({ distanceSquared, i });
+			}
+		});
+
+	const int32 resultCount = FMath::Min(count, static_cast<int32>(candidates.size()));
+
+	std::partial_sort(candidates.begin(), candidates.begin() + resultCount, candidates.end());
+
+	for (int32 i = 0; i < resultCount; i++)
+	{
+		results.Add(queryActors_[candidates[i].second].Get());
+	}
+}
+
+void ATrafficController::RegisterPawn(APawn* pawn)
+{
+	if (IsValid(pawn))
+	{
+		registeredPawns_.AddUnique(pawn);
+	}
+}
+
+void ATrafficController::UnregisterPawn(APawn* pawn)
+{
+	registeredPawns_.Remove(pawn);
+}
+
+void ATrafficController::RegisterExistingPawns()
+{
+	for (TActorIterator<APawn> it = TActorIterator<APawn>(GetWorld()); it; it.operator++())
+	{
+		// Simulated entities are already indexed as traffic entities and would be returned twice
+		ITrafficEntity* entity = Cast<ITrafficEntity>(*it);
+
+		if (entity != nullptr && std::find(simulatedEntities_.begin(), simulatedEntities_.end(), entity) != simulatedEntities_.end())
+		{
+			continue;
+		}
+
+		RegisterPawn(*it);
+	}
+}
+
+void ATrafficController::IndexQueryActors()
+{
+	// The player may have switched to a new pawn since the last tick
+	if (APlayerController* playerController = GetWorld()->GetFirstPlayerController())
+	{
+		RegisterPawn(playerController->GetPawn());
+	}
+
+	registeredPawns_.RemoveAll([](const TWeakObjectPtr<APawn>& pawn) { return !pawn.IsValid(); });
+
+	const int32 simulatedEntityCount = simulatedEntities_.size();
+	const int32 actorCount = simulatedEntityCount + registeredPawns_.Num();
+
+	queryActors_.resize(actorCount);
+	queryPositions_.resize(actorCount);
+	queryTypes_.resize(actorCount);
+	queryGrid_.Reset(actorCount);
+
+	for (int32 i = 0; i < actorCount; i++)
+	{
+		AActor* actor;
+		ETrafficQueryFilter type;
+
+		if (i < simulatedEntityCount)
+		{
+			ITrafficEntity* entity = simulatedEntities_[i];
+
+			actor = Cast<AActor>(entity);
+
+			if (Cast<ACar>(entity))
+			{
+				type = ETrafficQueryFilter::Cars;
+			}
+			else if (Cast<ATram>(entity))
+			{
+				type = ETrafficQueryFilter::Trams;
+			}
+			else if (Cast<APedestrian>(entity))
+			{
+				type = ETrafficQueryFilter::Pedestrians;
+			}
+			else if (Cast<ABicycle>(entity))
+			{
+				type = ETrafficQueryFilter::Bicycles;
+			}
+			else
+			{
+				type = ETrafficQueryFilter::None;
+			}
+		}
+		else
+		{
+			actor = registeredPawns_[i - simulatedEntityCount].Get();
+			type = ETrafficQueryFilter::Pawns;
+		}
+
+		const FVector2D position = FVector2D(actor->GetActorLocation());
+
+		queryActors_[i] = actor;
+		queryPositions_[i] = position;
+		queryTypes_[i] = type;
+
+		queryGrid_.SetBounds(i, FBox2D(position, position));
+	}
+
+	queryGrid_.Build();
+}
@@ -3,21 +3,49 @@
 #include "Pipeline/Pipeline.h"
 #include "Pipeline/Components/HevcEncoder.h"
 #include "Pipeline/Components/RtpTransmitter.h"
+#include "Pipeline/Components/RtpFanoutTransmitter.h"
 #include "Pipeline/Components/RenderTargetReader.h"
+#include "Pipeline/Components/RenderTargetReaderWithUserData.h"
+#include "Pipeline/Components/HevcEncoderWithRoi.h"
 #include "Pipeline/Components/RgbaToYuvConverter.h"
 #include "Pipeline/Components/Equirectangular360Converter.h"
 #include "Pipeline/Components/SolidColorImageGenerator.h"
 #include "Pipeline/Components/PngRecorder.h"
 #include "Pipeline/Components/BgraToRgbaConverter.h"
 #include "Pipeline/Components/FileSink.h"
+#include "Pipeline/Components/YuvScaler.h"
+#include "Pipeline/Components/RingBufferRecorder.h"
 #include "Pipeline/Scaffolding/SequentialFilter.h"
+#include "Pipeline/Scaffolding/ParallelFilter.h"
+#include "Pipeline/Scaffolding/SequentialSink.h"
+#include "Pipeline/Scaffolding/ConcurrentSink.h"
 #include "Pipeline/AsyncPipelineRunner.h"
 
+#include "Traffic/TrafficController.h"
+#include "Traffic/LodController.h"
+#include "Traffic/Entities/ITrafficEntity.h"
+
 #include "Misc/Debug.h"
+#include "Misc/CameraUtility.h"
+
+#include "Components/SceneCaptureComponent2D.h"
+#include "Kismet/GameplayStatics.h"
 
 #include <string>
 #include <algorithm>
 
+static uint16_t ToValidFrameDimension(const int& dimension)
+{
+	// Capturing below 16x16 causes corrupted video, might be because of SSE instructions in YUV conversion
+	uint16_t validDimension = std::max(dimension, 16);
+
+	// Width and height must be divisible by eight (HEVC limitation)
+	// This rounds up to the nearest integer divisible by eight
+	validDimension += (8 - (validDimension % 8)) % 8;
+
+	return validDimension;
+}
+
 AVideoTransmitter::AVideoTransmitter()
 {
 	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
@@ -104,7 +132,17 @@ void AVideoTransmitter::Tick(float deltaTime)
 		normalCamera_->CaptureScene();
 	}
 
-	reader_->Read();
+	if (roiReader_)
+	{
+		// The regions of interest are passed with the frame so that they stay in sync with the image
+		std::vector<RoiMapGenerator::Rectangle> regions = GetTrafficRegionsOfInterest();
+
+		roiReader_->Read(reinterpret_cast<uint8_t*>(regions.data()), regions.size() * sizeof(RoiMapGenerator::Rectangle));
+	}
+	else
+	{
+		reader_->Read();
+	}
 }
 
 void AVideoTransmitter::StartTransmit()
@@ -125,6 +163,53 @@ void AVideoTransmitter::StopTransmit()
 	wantsStop_ = true;
 }
 
+bool AVideoTransmitter::AddViewer(const FString& ip, int port)
+{
+	std::lock_guard<std::mutex> lock(streamMutex_);
+
+	if (!transmitter_)
+	{
+		Debug::Log("Viewers can only be added to a running non-simulcast stream");
+
+		return false;
+	}
+
+	return transmitter_->AddDestination(TCHAR_TO_UTF8(*ip), port);
+}
+
+bool AVideoTransmitter::RemoveViewer(const FString& ip, int port)
+{
+	std::lock_guard<std::mutex> lock(streamMutex_);
+
+	if (!transmitter_)
+	{
+		return false;
+	}
+
+	return transmitter_->RemoveDestination(TCHAR_TO_UTF8(*ip), port);
+}
+
+bool AVideoTransmitter::SaveReplay()
+{
+	std::lock_guard<std::mutex> lock(streamMutex_);
+
+	if (!replayRecorder_)
+	{
+		Debug::Log("Replays can only be saved from a running stream with the replay buffer enabled");
+
+		return false;
+	}
+
+	if (!replayRecorder_->Trigger())
+	{
+		Debug::Log("Previous replay is still being saved");
+
+		return false;
+	}
+
+	return true;
+}
+
 bool AVideoTransmitter::StartStreams()
 {
 	// TODO: More sanity checks should be added here
@@ -135,14 +220,8 @@ bool AVideoTransmitter::StartStreams()
 		return false;
 	}
 
-	// Capturing below 16x16 causes corrupted video, might be because of SSE instructions in YUV conversion
-	uint16_t frameWidth = std::max(remoteStreamWidth_, 16);
-	uint16_t frameHeight = std::max(remoteStreamHeight_, 16);
-
-	// Width and height must be divisible by eight (HEVC limitation)
-	// This rounds up to the nearest integers divisible by eight
-	frameWidth += (8 - (frameWidth % 8)) % 8;
-	frameHeight += (8 - (frameHeight % 8)) % 8;
+	uint16_t frameWidth = ToValidFrameDimension(remoteStreamWidth_);
+	uint16_t frameHeight = ToValidFrameDimension(remoteStreamHeight_);
 
 	capture360_ = enable360Capture_;
 
@@ -183,10 +262,7 @@ bool AVideoTransmitter::StartStreams()
 						new Equirectangular360Converter(widthAndHeightPerCaptureSide_, widthAndHeightPerCaptureSide_,
 							frameWidth, frameHeight, bilinearFiltering_),
 						new RgbaToYuvConverter(frameWidth, frameHeight),
-						new HevcEncoder(frameWidth, frameHeight,
-							processingThreadCount_, quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_,
-							saveToFile_ ? HevcPresetLossless : HevcPresetMinimumLatency),
-						new RtpTransmitter(TCHAR_TO_UTF8(*remoteStreamIp_), remoteVideoDstPort_)));
+						CreateStreamSink(frameWidth, frameHeight)));
 			}
 		}
 		else
@@ -196,6 +272,41 @@ bool AVideoTransmitter::StartStreams()
 
 			std::vector<UTextureRenderTarget2D*> renderTargets = { normalCamera_->TextureTarget };
 
+			trafficController_ = nullptr;
+
+			if (enableTrafficRoi_ && !saveToFile_)
+			{
+				if (enableSimulcast_)
+				{
+					throw std::invalid_argument("Region of interest encoding is not supported with simulcast");
+				}
+
+				trafficController_ = Cast<ATrafficController>(UGameplayStatics::GetActorOfClass(GetWorld(), ATrafficController::StaticClass()));
+
+				if (!trafficController_.IsValid())
+				{
+					Debug::Log("No traffic controller found, streaming without regions of interest");
+				}
+			}
+
+			if (trafficController_.IsValid())
+			{
+				roiReader_ = new RenderTargetReaderWithUserData(renderTargets);
+
+				runner_ = new AsyncPipelineRunner(
+					new Pipeline(
+						roiReader_,
+						new ParallelFilter(
+							new RgbaToYuvConverter(frameWidth, frameHeight),
+							new RoiMapGenerator(frameWidth, frameHeight, roiDeltaQp_, backgroundDeltaQp_)),
+						new HevcEncoderWithRoi(frameWidth, frameHeight,
+							processingThreadCount_, quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_,
+							HevcPresetMinimumLatency),
+						CreateTransmitSink()));
+
+				return true;
+			}
+
 			reader_ = new RenderTargetReader(renderTargets);
 
 			if (saveToFile_)
@@ -212,10 +323,7 @@ bool AVideoTransmitter::StartStreams()
 					new Pipeline(
 						reader_,
 						new RgbaToYuvConverter(frameWidth, frameHeight),
-						new HevcEncoder(frameWidth, frameHeight,
-							processingThreadCount_, quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_,
-							saveToFile_ ? HevcPresetLossless : HevcPresetMinimumLatency),
-						new RtpTransmitter(TCHAR_TO_UTF8(*remoteStreamIp_), remoteVideoDstPort_)));
+						CreateStreamSink(frameWidth, frameHeight)));
 			}
 		}
 	}
@@ -243,8 +351,107 @@ void AVideoTransmitter::DeleteStreams()
 	delete runner_;
 	runner_ = nullptr;
 
-	// This is already deleted by the pipeline so don't delete it twice
+	// These are already deleted by the pipeline so don't delete them twice
 	reader_ = nullptr;
+	roiReader_ = nullptr;
+	transmitter_ = nullptr;
+	replayRecorder_ = nullptr;
+}
+
+PipelineSink<1>* AVideoTransmitter::CreateStreamSink(const uint16_t& frameWidth, const uint16_t& frameHeight)
+{
+	if (!enableSimulcast_)
+	{
+		return new SequentialSink(
+			new HevcEncoder(frameWidth, frameHeight,
+				processingThreadCount_, quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_,
+				HevcPresetMinimumLatency),
+			CreateTransmitSink());
+	}
+
+	if (enableReplayBuffer_)
+	{
+		Debug::Log("The replay buffer is not supported with simulcast, streaming without it");
+	}
+
+	if (simulcastLayers_.IsEmpty())
+	{
+		throw std::invalid_argument("Simulcast is enabled but no simulcast layers have been defined");
+	}
+
+	// The layers are encoded simultaneously, so they share the processing threads
+	uint8_t threadsPerLayer = std::max(1, processingThreadCount_ / simulcastLayers_.Num());
+
+	std::vector<PipelineSink<1>*> layerSinks;
+
+	// The frame is captured and converted to YUV only once, after which each layer scales it to its own resolution
+	for (const FSimulcastLayer& layer : simulcastLayers_)
+	{
+		uint16_t layerWidth = ToValidFrameDimension(layer.width);
+		uint16_t layerHeight = ToValidFrameDimension(layer.height);
+
+		layerSinks.push_back(
+			new SequentialSink(
+				new YuvScaler(frameWidth, frameHeight, layerWidth, layerHeight),
+				new HevcEncoder(layerWidth, layerHeight,
+					threadsPerLayer, layer.quantizationParameter, wavefrontParallelProcessing_, overlappedWavefront_,
+					HevcPresetMinimumLatency),
+				new RtpTransmitter(TCHAR_TO_UTF8(*remoteStreamIp_), layer.remoteVideoDstPort)));
+	}
+
+	return new ConcurrentSink<1>(layerSinks);
+}
+
+PipelineSink<1>* AVideoTransmitter::CreateTransmitSink()
+{
+	transmitter_ = new RtpFanoutTransmitter(TCHAR_TO_UTF8(*remoteStreamIp_), remoteVideoDstPort_);
+
+	if (!enableReplayBuffer_)
+	{
+		return transmitter_;
+	}
+
+	replayRecorder_ = new RingBufferRecorder(
+		TCHAR_TO_UTF8(*(saveDirectory_ + "Replays/")), replayBufferSeconds_, static_cast<uint64_t>(std::max(replayBufferMegabytes_, 1)) * 1024 * 1024);
+
+	// The encoded stream is buffered alongside transmitting it
+	return new ConcurrentSink<1>({ transmitter_, replayRecorder_ });
+}
+
+std::vector<RoiMapGenerator::Rectangle> AVideoTransmitter::GetTrafficRegionsOfInterest() const
+{
+	std::vector<RoiMapGenerator::Rectangle> regions;
+
+	// The traffic controller may have been destroyed while streaming, in which case there's nothing to mark
+	ATrafficController* trafficController = trafficController_.Get();
+
+	if (!trafficController)
+	{
+		return regions;
+	}
+
+	LodController* lodController = trafficController->GetLodController();
+
+	if (!lodController)
+	{
+		return regions;
+	}
+
+	const FTransform cameraTransform = normalCamera_->GetComponentTransform();
+	const float aspectRatio = static_cast<float>(normalCamera_->TextureTarget->SizeX) / normalCamera_->TextureTarget->SizeY;
+
+	// Cull with the view of this camera rather than the player camera the LODs are based on
+	for (ITrafficEntity* entity : lodController->GetEntitiesInView(cameraTransform.GetLocation(), cameraTransform.Rotator(), normalCamera_->FOVAngle, aspectRatio))
+	{
+		FBox2D bounds;
+
+		if (CameraUtility::GetProjectedBounds(entity->GetCollisionRectangle().GetCorners(), cameraTransform, normalCamera_->FOVAngle, aspectRatio, bounds))
+		{
+			regions.push_back({ static_cast<float>(bounds.Min.X), static_cast<float>(bounds.Min.Y), static_cast<float>(bounds.Max.X), static_cast<float>(bounds.Max.Y) });
+		}
+	}
+
+	return regions;
 }
 
 void AVideoTransmitter::StopTransmitInternal()
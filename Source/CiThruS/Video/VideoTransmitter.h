@@ -14,12 +14,39 @@
 #include <thread>
 #include <mutex>
 
+#include "Pipeline/Internal/PipelineSink.h"
+#include "Pipeline/Components/RoiMapGenerator.h"
+
 #include "VideoTransmitter.generated.h"
 
 class USceneCaptureComponent2D;
 class RenderTargetReader;
+class RenderTargetReaderWithUserData;
+class ATrafficController;
+class RtpFanoutTransmitter;
+class RingBufferRecorder;
 class AsyncPipelineRunner;
 
+// One resolution of a simulcast stream
+USTRUCT(BlueprintType)
+struct FSimulcastLayer
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int width = 1280;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int height = 720;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int quantizationParameter = 27;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere)
+	int remoteVideoDstPort = 12300;
+};
+
 // Transmits 360 or regular video through an RTP stream
 UCLASS()
 class CITHRUS_API AVideoTransmitter : public AActor
@@ -37,6 +64,17 @@ public:
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Stream Controls")
 	void StopTransmit();
 
+	// Sends the running stream to another destination as well without encoding it again. Not available with simulcast
+	UFUNCTION(BlueprintCallable, Category = "Stream Controls")
+	bool AddViewer(const FString& ip, int port);
+
+	UFUNCTION(BlueprintCallable, Category = "Stream Controls")
+	bool RemoveViewer(const FString& ip, int port);
+
+	// Saves the last replayBufferSeconds_ of the running stream into saveDirectory_/Replays/
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Stream Controls")
+	bool SaveReplay();
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "General Stream Settings")
 	FString remoteStreamIp_ = "127.0.0.1";
 
@@ -79,12 +117,47 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "360 Stream Settings")
 	bool bilinearFiltering_ = true;
 
+	// Encodes the captured video at each of the given resolutions simultaneously instead of only
+	// at the remote stream resolution. Each layer is sent to its own port
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Simulcast Settings")
+	bool enableSimulcast_ = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Simulcast Settings")
+	TArray<FSimulcastLayer> simulcastLayers_;
+
+	// Encodes the traffic entities visible to the camera at a lower QP than the rest of the image. Only
+	// applies to regular (non-360) streams and requires a traffic controller in the level
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Region of Interest Settings")
+	bool enableTrafficRoi_ = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Region of Interest Settings")
+	int roiDeltaQp_ = -6;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Region of Interest Settings")
+	int backgroundDeltaQp_ = 4;
+
+	// Keeps the most recent encoded video in memory so that it can be saved with SaveReplay when something
+	// interesting happens. Not available with simulcast
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Replay Buffer Settings")
+	bool enableReplayBuffer_ = false;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Replay Buffer Settings")
+	float replayBufferSeconds_ = 30.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Replay Buffer Settings")
+	int replayBufferMegabytes_ = 256;
+
 private:
 	TArray<USceneCaptureComponent2D*> cubemapCameras_;
 	USceneCaptureComponent2D* normalCamera_;
 
 	AsyncPipelineRunner* runner_;
 	RenderTargetReader* reader_;
+	RenderTargetReaderWithUserData* roiReader_;
+	RtpFanoutTransmitter* transmitter_;
+	RingBufferRecorder* replayRecorder_;
+
+	TWeakObjectPtr<ATrafficController> trafficController_;
 
 	std::mutex streamMutex_;
 
@@ -104,4 +177,9 @@ private:
 	bool ResetStreams();
 
 	void StopTransmitInternal();
+
+	PipelineSink<1>* CreateStreamSink(const uint16_t& frameWidth, const uint16_t& frameHeight);
+	PipelineSink<1>* CreateTransmitSink();
+
+	std::vector<RoiMapGenerator::Rectangle> GetTrafficRegionsOfInterest() const;
 };
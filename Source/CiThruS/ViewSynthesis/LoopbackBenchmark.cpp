@@ -0,0 +1,259 @@
+#include "LoopbackBenchmark.h"
+
+#include "Pipeline/Pipeline.h"
+#include "Pipeline/AsyncPipelineRunner.h"
+#include "Pipeline/Components/TestPatternGenerator.h"
+#include "Pipeline/Components/TestPatternAnalyzer.h"
+#include "Pipeline/Components/HevcEncoder.h"
+#include "Pipeline/Components/HevcDecoder.h"
+#include "Pipeline/Components/HevcStatisticsProbe.h"
+#include "Pipeline/Components/RtpTransmitter.h"
+#include "Pipeline/Components/RtpReceiver.h"
+
+#include "Misc/Debug.h"
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+
+ALoopbackBenchmark::ALoopbackBenchmark() : cancelled_(false), sentFrames_(0), receivedFrames_(0)
+{
+	RootComponent = CreateDefaultSubobject<USceneComponent>(TEXT("RootComponent"));
+
+	// Set this actor to call Tick() every frame
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void ALoopbackBenchmark::Tick(float deltaTime)
+{
+	Super::Tick(deltaTime);
+
+	std::vector<std::string> results;
+
+	{
+		const std::lock_guard<std::mutex> lock(resultMutex_);
+
+		results.swap(pendingResults_);
+	}
+
+	for (const std::string& result : results)
+	{
+		Debug::Log(result);
+	}
+}
+
+void ALoopbackBenchmark::EndPlay(const EEndPlayReason::Type endPlayReason)
+{
+	Super::EndPlay(endPlayReason);
+
+	StopBenchmark();
+}
+
+void ALoopbackBenchmark::BeginDestroy()
+{
+	StopBenchmark();
+
+	Super::BeginDestroy();
+}
+
+void ALoopbackBenchmark::RunBenchmark()
+{
+	StopBenchmark();
+
+	std::vector<Configuration> configurations;
+
+	for (const FIntPoint& resolution : resolutions_)
+	{
+		for (const int& qp : quantizationParameters_)
+		{
+			for (const int& threadCount : threadCounts_)
+			{
+				configurations.push_back({
+					static_cast<uint16_t>(resolution.X), static_cast<uint16_t>(resolution.Y),
+					static_cast<uint8_t>(qp), static_cast<uint8_t>(threadCount) });
+			}
+		}
+	}
+
+	// The frame number stamp only has room for this many frames
+	uint32_t frameCount = std::clamp(framesPerRun_, 1, static_cast<int>(std::numeric_limits<uint16_t>::max()));
+
+	cancelled_ = false;
+	benchmarkThread_ = std::thread(&ALoopbackBenchmark::RunBenchmarkAsync, this, configurations, frameCount, frameRate_, port_, drainTimeout_);
+}
+
+void ALoopbackBenchmark::StopBenchmark()
+{
+	cancelled_ = true;
+
+	if (benchmarkThread_.joinable())
+	{
+		benchmarkThread_.join();
+	}
+}
+
+void ALoopbackBenchmark::RunBenchmarkAsync(std::vector<Configuration> configurations, uint32_t frameCount, float frameRate, int port, float drainTimeout)
+{
+	AddResult("Loopback benchmark: " + std::to_string(configurations.size()) + " configurations, " + std::to_string(frameCount) + " frames each");
+
+	for (const Configuration& configuration : configurations)
+	{
+		if (cancelled_)
+		{
+			AddResult("Loopback benchmark cancelled");
+
+			return;
+		}
+
+		try
+		{
+			AddResult(RunConfiguration(configuration, frameCount, frameRate, port, drainTimeout));
+		}
+		catch (const std::exception& exception)
+		{
+			AddResult("Loopback benchmark configuration failed: " + std::string(exception.what()));
+		}
+	}
+
+	AddResult("Loopback benchmark finished");
+}
+
+std::string ALoopbackBenchmark::RunConfiguration(const Configuration& configuration, const uint32_t& frameCount, const float& frameRate, const int& port, const float& drainTimeout)
+{
+	// Preallocated so that recording the timestamps doesn't affect the measurement
+	sendTimes_.assign(frameCount, std::chrono::steady_clock::time_point::min());
+	receiveTimes_.assign(frameCount, std::chrono::steady_clock::time_point::min());
+
+	sentFrames_ = 0;
+	receivedFrames_ = 0;
+
+	HevcStatisticsProbe* sentProbe = new HevcStatisticsProbe();
+	HevcStatisticsProbe* receivedProbe = new HevcStatisticsProbe();
+
+	// Only the first arrival of each frame counts in case the same frame is decoded more than once
+	TestPatternAnalyzer* analyzer = new TestPatternAnalyzer(configuration.width, configuration.height, [this, frameCount](const uint32_t& frameNumber)
+		{
+			if (frameNumber < frameCount && receiveTimes_[frameNumber] == std::chrono::steady_clock::time_point::min())
+			{
+				receiveTimes_[frameNumber] = std::chrono::steady_clock::now();
+				receivedFrames_++;
+			}
+		});
+
+	TestPatternGenerator* generator = new TestPatternGenerator(configuration.width, configuration.height, frameCount, frameRate, [this](const uint32_t& frameNumber)
+		{
+			sendTimes_[frameNumber] = std::chrono::steady_clock::now();
+			sentFrames_++;
+		});
+
+	// Start receiving first so that the first frames aren't lost
+	AsyncPipelineRunner* receiverRunner = new AsyncPipelineRunner(
+		new Pipeline(
+			new RtpReceiver("127.0.0.1", port),
+			receivedProbe,
+			new HevcDecoder(configuration.threadCount),
+			analyzer));
+
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	Pipeline* sender = nullptr;
+
+	// The sender is run on this thread so that it stops as soon as the last frame has been sent. In a runner it would
+	// keep spinning on the finished generator and take CPU time away from the receiver while waiting for the rest
+	try
+	{
+		sender = new Pipeline(
+			generator,
+			new HevcEncoder(configuration.width, configuration.height, configuration.threadCount, configuration.qp, 1, 0, HevcPresetMinimumLatency),
+			sentProbe,
+			new RtpTransmitter("127.0.0.1", port));
+
+		while (!cancelled_ && sentFrames_ < frameCount)
+		{
+			sender->Run();
+		}
+	}
+	catch (...)
+	{
+		delete sender;
+		delete receiverRunner;
+
+		throw;
+	}
+
+	const std::chrono::steady_clock::time_point sendEndTime = std::chrono::steady_clock::now();
+	const std::chrono::steady_clock::time_point drainEndTime = sendEndTime
+		+ std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<float>(drainTimeout));
+
+	while (!cancelled_ && receivedFrames_ < frameCount && std::chrono::steady_clock::now() < drainEndTime)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+
+	// Read the counters before the probes are deleted along with their pipelines
+	const uint64_t sentBytes = sentProbe->GetByteCount();
+	const uint64_t sentNalUnits = sentProbe->GetNalUnitCount();
+	const uint64_t receivedBytes = receivedProbe->GetByteCount();
+	const uint64_t receivedNalUnits = receivedProbe->GetNalUnitCount();
+
+	delete sender;
+	delete receiverRunner;
+
+	const float sendDuration = std::chrono::duration<float>(sendEndTime - startTime).count();
+	const uint32_t sent = sentFrames_;
+	const uint32_t received = receivedFrames_;
+
+	std::vector<float> latencies;
+	latencies.reserve(received);
+
+	for (uint32_t i = 0; i < frameCount; i++)
+	{
+		if (sendTimes_[i] != std::chrono::steady_clock::time_point::min() && receiveTimes_[i] != std::chrono::steady_clock::time_point::min())
+		{
+			latencies.push_back(std::chrono::duration<float, std::milli>(receiveTimes_[i] - sendTimes_[i]).count());
+		}
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+
+	auto percentile = [&latencies](const float& p)
+		{
+			return latencies.empty() ? 0.0f : latencies[std::min(static_cast<size_t>(p * latencies.size()), latencies.size() - 1)];
+		};
+
+	float meanLatency = 0.0f;
+
+	for (const float& latency : latencies)
+	{
+		meanLatency += latency;
+	}
+
+	meanLatency = latencies.empty() ? 0.0f : meanLatency / latencies.size();
+
+	std::ostringstream result;
+
+	result << std::fixed << std::setprecision(1)
+		<< configuration.width << "x" << configuration.height
+		<< " QP " << static_cast<int>(configuration.qp)
+		<< " threads " << static_cast<int>(configuration.threadCount)
+		<< ": " << (sendDuration > 0.0f ? sent / sendDuration : 0.0f) << " fps, "
+		<< std::setprecision(2) << (sendDuration > 0.0f ? sentBytes * 8.0f / sendDuration / 1000000.0f : 0.0f) << " Mbps, "
+		<< "frame loss " << (sent > 0 ? 100.0f * (sent - std::min(received, sent)) / sent : 0.0f) << "%, "
+		// NAL units are the smallest unit RtpReceiver can tell apart, so this stands in for packet loss
+		<< "NAL unit loss " << (sentNalUnits > 0 ? 100.0f * (sentNalUnits - std::min(receivedNalUnits, sentNalUnits)) / sentNalUnits : 0.0f) << "% "
+		<< "(" << receivedBytes << "/" << sentBytes << " bytes), "
+		<< std::setprecision(1) << "latency ms mean " << meanLatency
+		<< " p50 " << percentile(0.5f)
+		<< " p95 " << percentile(0.95f)
+		<< " max " << (latencies.empty() ? 0.0f : latencies.back());
+
+	return result.str();
+}
+
+void ALoopbackBenchmark::AddResult(const std::string& result)
+{
+	const std::lock_guard<std::mutex> lock(resultMutex_);
+
+	pendingResults_.push_back(result);
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <chrono>
+
+#include "LoopbackBenchmark.generated.h"
+
+// Measures the whole streaming path by sending a test pattern through HevcEncoder and RtpTransmitter
+// and receiving it locally through RtpReceiver and HevcDecoder. Every combination of the given
+// resolutions, QPs and thread counts is run in turn and the results are printed to the log
+UCLASS()
+class ALoopbackBenchmark : public AActor
+{
+	GENERATED_BODY()
+	
+public:	
+	ALoopbackBenchmark();
+
+	virtual void Tick(float deltaTime) override;
+
+	inline virtual bool ShouldTickIfViewportsOnly() const override { return true; }
+
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Benchmark Controls")
+	void RunBenchmark();
+
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "Benchmark Controls")
+	void StopBenchmark();
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Benchmark Settings")
+	TArray<FIntPoint> resolutions_ = { FIntPoint(1280, 720), FIntPoint(1920, 1080) };
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Benchmark Settings")
+	TArray<int> quantizationParameters_ = { 22, 27, 32 };
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Benchmark Settings")
+	TArray<int> threadCounts_ = { 4, 8 };
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Benchmark Settings")
+	int framesPerRun_ = 300;
+
+	// 0 sends frames as fast as the encoder can take them
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Benchmark Settings")
+	float frameRate_ = 30.0f;
+
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Benchmark Settings")
+	int port_ = 23000;
+
+	// How long to wait for frames still in flight after the last frame has been sent
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Benchmark Settings")
+	float drainTimeout_ = 2.0f;
+
+protected:
+	struct Configuration
+	{
+		uint16_t width;
+		uint16_t height;
+		uint8_t qp;
+		uint8_t threadCount;
+	};
+
+	std::thread benchmarkThread_;
+	std::atomic<bool> cancelled_;
+
+	// The results are printed from the game thread
+	std::mutex resultMutex_;
+	std::vector<std::string> pendingResults_;
+
+	std::vector<std::chrono::steady_clock::time_point> sendTimes_;
+	std::vector<std::chrono::steady_clock::time_point> receiveTimes_;
+
+	std::atomic<uint32_t> sentFrames_;
+	std::atomic<uint32_t> receivedFrames_;
+
+	virtual void EndPlay(const EEndPlayReason::Type endPlayReason) override;
+	virtual void BeginDestroy() override;
+
+	void RunBenchmarkAsync(std::vector<Configuration> configurations, uint32_t frameCount, float frameRate, int port, float drainTimeout);
+	std::string RunConfiguration(const Configuration& configuration, const uint32_t& frameCount, const float& frameRate, const int& port, const float& drainTimeout);
+
+	void AddResult(const std::string& result);
+};
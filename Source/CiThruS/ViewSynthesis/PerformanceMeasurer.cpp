@@ -6,6 +6,7 @@
 #include "Pipeline/Components/RgbaToYuvConverter.h"
 #include "Pipeline/Components/HevcEncoder.h"
 #include "Pipeline/Components/RtpTransmitter.h"
+#include "Pipeline/Components/MosaicPacker.h"
 #include "Pipeline/Scaffolding/SequentialFilter.h"
 
 #include "Misc/Debug.h"
@@ -18,6 +19,7 @@
 #include "RenderResource.h"
 
 #include <algorithm>
+#include <limits>
 
 APerformanceMeasurer::APerformanceMeasurer()
 {
@@ -101,7 +103,7 @@ void APerformanceMeasurer::Tick(float deltaTime)
         cameras_[i]->CaptureScene();
     }
 
-    for (int i = 0; i < activeCameras_; i++)
+    for (int i = 0; i < activeStreams_; i++)
     {
         readers_[i]->Read();
     }
@@ -130,21 +132,81 @@ void APerformanceMeasurer::StartStreams()
     for (int i = 0; i < activeCameras_; i++)
     {
         renderTargets_[i]->ResizeTarget(remoteStreamWidth_, remoteStreamHeight_);
+    }
+
+    if (mosaicMode_)
+    {
+        StartMosaicStream();
+
+        return;
+    }
+
+    activeStreams_ = activeCameras_;
+
+    for (int i = 0; i < activeStreams_; i++)
+    {
         readers_[i] = new RenderTargetReader({ renderTargets_[i] }, true);
 
         runners_[i] = new AsyncPipelineRunner(
             new Pipeline(
                 readers_[i],
                 new RgbaToYuvConverter(remoteStreamWidth_, remoteStreamHeight_),
-                new HevcEncoder(remoteStreamWidth_, remoteStreamHeight_, 16,
+                new HevcEncoder(remoteStreamWidth_, remoteStreamHeight_, GetEncoderThreadCount(activeStreams_),
                     quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_),
                 new RtpTransmitter(TCHAR_TO_UTF8(*remoteStreamIp_), remoteStreamPort_ + i)));
     }
 }
 
-void APerformanceMeasurer::DeleteStreams()
+void APerformanceMeasurer::StartMosaicStream()
 {
+    if (activeCameras_ <= 0)
+    {
+        return;
+    }
+
+    activeStreams_ = 1;
+
+    std::vector<UTextureRenderTarget2D*> mosaicTargets;
+
     for (int i = 0; i < activeCameras_; i++)
+    {
+        mosaicTargets.push_back(renderTargets_[i]);
+    }
+
+    // The reader outputs the camera images concatenated vertically, which are then arranged into a grid
+    // so that each camera ends up in its own tile
+    std::pair<uint8_t, uint8_t> gridSize = MosaicPacker::GetGridSize(activeCameras_);
+    std::pair<uint16_t, uint16_t> mosaicResolution = MosaicPacker::GetPackedResolution(remoteStreamWidth_, remoteStreamHeight_, activeCameras_);
+
+    readers_[0] = new RenderTargetReader(mosaicTargets, true);
+
+    runners_[0] = new AsyncPipelineRunner(
+        new Pipeline(
+            readers_[0],
+            new RgbaToYuvConverter(remoteStreamWidth_, remoteStreamHeight_ * activeCameras_),
+            new MosaicPacker(remoteStreamWidth_, remoteStreamHeight_, activeCameras_),
+            new HevcEncoder(mosaicResolution.first, mosaicResolution.second, GetEncoderThreadCount(1),
+                quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_, HevcPresetNone,
+                gridSize.first, gridSize.second),
+            new RtpTransmitter(TCHAR_TO_UTF8(*remoteStreamIp_), remoteStreamPort_)));
+}
+
+uint8_t APerformanceMeasurer::GetEncoderThreadCount(const int& encoderCount) const
+{
+    int threadCount = encoderThreadCount_;
+
+    if (threadCount <= 0)
+    {
+        // hardware_concurrency can return 0 if the number of threads is unknown
+        threadCount = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1) / std::max(encoderCount, 1);
+    }
+
+    return static_cast<uint8_t>(std::clamp(threadCount, 1, static_cast<int>(std::numeric_limits<uint8_t>::max())));
+}
+
+void APerformanceMeasurer::DeleteStreams()
+{
+    for (int i = 0; i < activeStreams_; i++)
     {
         delete runners_[i];
         runners_[i] = nullptr;
@@ -152,6 +214,8 @@ void APerformanceMeasurer::DeleteStreams()
         // This is already deleted by the pipeline so don't delete it twice
         readers_[i] = nullptr;
     }
+
+    activeStreams_ = 0;
 }
 
 void APerformanceMeasurer::ResetStreams()
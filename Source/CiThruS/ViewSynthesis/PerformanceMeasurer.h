@@ -61,6 +61,10 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "General Stream Settings")
 	int remoteStreamHeight_ = 1024;
 
+	// Pack all cameras into a single grid image encoded as one stream, with one motion-constrained tile per camera
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "General Stream Settings")
+	bool mosaicMode_ = false;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Kvazaar Settings")
 	int overlappedWavefront_ = 3;
 
@@ -70,6 +74,10 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Kvazaar Settings")
 	int quantizationParameter_ = 27;
 
+	// Worker threads per encoder. 0 shares the hardware threads of this machine evenly between the encoders
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Kvazaar Settings")
+	int encoderThreadCount_ = 0;
+
 	UPROPERTY(BlueprintReadOnly)
 	float minFps_;
 
@@ -94,6 +102,7 @@ protected:
 	std::array<AsyncPipelineRunner*, MAX_CAMERAS> runners_;
 
 	int activeCameras_;
+	int activeStreams_ = 0;
 
 	bool wantsStop_ = false;
 
@@ -108,6 +117,9 @@ protected:
 	void DeleteStreams();
 
 	void StartStreams();
+	void StartMosaicStream();
+
+	uint8_t GetEncoderThreadCount(const int& encoderCount) const;
 
 	void StopTransmitInternal();
 };
@@ -10,6 +10,7 @@
 #include "Pipeline/Components/YuvToRgbaConverter.h"
 #include "Pipeline/Components/DepthToYuvConverter.h"
 #include "Pipeline/Components/DepthSeparator.h"
+#include "Pipeline/Components/ColorDepthPacker.h"
 #include "Pipeline/Components/ImageConcatenator.h"
 #include "Pipeline/Components/SeiEmbedder.h"
 #include "Pipeline/Components/CsvLogger.h"
@@ -158,6 +159,7 @@ bool AViewSynthesizer::StartStreams()
     wantsStop_ = false;
     frameNumber_ = 0;
     startTimestampMs_ = 0;
+    streamedDepthLayout_ = ColorDepthVertical;
 
     frontCamera_->FOVAngle = frontFov_;
     rearCamera_->FOVAngle = rearFov_;
@@ -189,6 +191,11 @@ bool AViewSynthesizer::StartStreams()
         }
         else
         {
+            ColorDepthLayout depthLayout = static_cast<ColorDepthLayout>(depthPackingLayout_);
+            std::pair<uint16_t, uint16_t> packedResolution = ColorDepthPacker::GetPackedResolution(frameWidth, frameHeight, depthLayout);
+
+            streamedDepthLayout_ = depthLayout;
+
             frontReader_ = new RenderTargetReaderWithUserData({ frontRenderTarget_ }, true, depthRange_);
             rearReader_ = new RenderTargetReaderWithUserData({ rearRenderTarget_ }, true, depthRange_);
 
@@ -202,8 +209,8 @@ bool AViewSynthesizer::StartStreams()
                                 new ParallelFilter(
                                     new RgbaToYuvConverter(frameWidth, frameHeight),
                                     new DepthToYuvConverter()),
-                                new ImageConcatenator<2>(frameWidth, frameHeight),
-                                new HevcEncoder(frameWidth, frameHeight * 2, 28,
+                                new ColorDepthPacker(frameWidth, frameHeight, depthLayout),
+                                new HevcEncoder(packedResolution.first, packedResolution.second, 28,
                                     quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_, HevcPresetMinimumLatency)),
                             new PassthroughFilter<1>()),
                         new SeiEmbedder("CiThruSViewSynth"),
@@ -216,8 +223,10 @@ bool AViewSynthesizer::StartStreams()
                         new ParallelFilter(
                             new SequentialFilter(
                                 new RgbaToYuvConverter(frameWidth, frameHeight),
+                                // The rear camera has no depth, but receivers expect the rear stream in the vertical layout
+                                // so a blank depth image is appended below the color
                                 new SidechainSource(
-                                    new SolidColorImageGenerator(frameWidth, frameHeight, 0, 128, 128),
+                                    new SolidColorImageGenerator(frameWidth, frameHeight, 0, DepthToYuvConverter::DEPTH_CHROMA, DepthToYuvConverter::DEPTH_CHROMA),
                                     new ImageConcatenator<2>(frameWidth, frameHeight)),
                                 new HevcEncoder(frameWidth, frameHeight * 2, 28,
                                     quantizationParameter_, wavefrontParallelProcessing_, overlappedWavefront_, HevcPresetMinimumLatency)),
@@ -315,6 +324,7 @@ void AViewSynthesizer::Capture()
         frontCameraParams.depthRange = depthRange_;
 
         frontCameraParams.timestamp = timestampMs - startTimestampMs_;
+        frontCameraParams.depthLayout = streamedDepthLayout_;
 
         frontReader_->Read(reinterpret_cast<uint8_t*>(&frontCameraParams), sizeof(ViewSynthCameraParams));
     }
@@ -337,6 +347,7 @@ void AViewSynthesizer::Capture()
         rearCameraParams.depthRange = depthRange_;
 
         rearCameraParams.timestamp = timestampMs - startTimestampMs_;
+        rearCameraParams.depthLayout = ColorDepthVertical;
 
         rearReader_->Read(reinterpret_cast<uint8_t*>(&rearCameraParams), sizeof(ViewSynthCameraParams));
     }
@@ -18,6 +18,17 @@ class RenderTargetReaderWithUserData;
 class RenderTargetWriter;
 class AsyncPipelineRunner;
 
+// How the color and depth images of the front camera are packed into a single video frame.
+// The values must match ColorDepthLayout
+UENUM(BlueprintType)
+enum class EDepthPackingLayout : uint8
+{
+	Vertical = 0			UMETA(DisplayName = "Depth below color"),
+	SideBySide = 1			UMETA(DisplayName = "Depth next to color"),
+	ReducedResolution = 2	UMETA(DisplayName = "Half resolution depth below color"),
+	Chroma = 3				UMETA(DisplayName = "Half resolution depth in chroma, grayscale color")
+};
+
 // Performs view synthesis
 UCLASS()
 class AViewSynthesizer : public AActor
@@ -73,6 +84,9 @@ public:
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Depth Settings")
 	float depthRange_ = 150.0f;
 
+	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Depth Settings")
+	EDepthPackingLayout depthPackingLayout_ = EDepthPackingLayout::Vertical;
+
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Depth Settings")
 	TObjectPtr<UTextureRenderTarget2D> resultRenderTarget_ = nullptr;
 
@@ -85,6 +99,8 @@ protected:
 		float fov;
 		float depthRange;
 		uint64_t timestamp;
+		// ColorDepthLayout of the stream so that receivers know how to unpack the depth
+		uint32_t depthLayout;
 	};
 
 	bool transmitEnabled_ = false;
@@ -109,6 +125,8 @@ protected:
 
 	uint32_t frameNumber_;
 	uint64_t startTimestampMs_;
+	// The layout is fixed when the streams are started even if depthPackingLayout_ changes afterwards
+	uint32_t streamedDepthLayout_;
 
 	bool wantsStop_ = false;
 
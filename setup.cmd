@@ -9,6 +9,8 @@ set YASM_VER=1.3.0
 set UVGRTP_VER=3.1.6
 set OPENHEVC_VER=ffmpeg_update
 set FPNG_VER=1.0.6
+set LZ4_VER=1.10.0
+set ZSTD_VER=1.5.7
 set OPENSSL_VER=3.6.1
 set PAHO_C_VER=1.3.15
 set PAHO_CPP_VER=1.5.3
@@ -415,6 +417,78 @@ echo %COLOR_SUCCESS%fpng successfully set up.%COLOR_RESET%
 
 exit /b 0
 
+:lz4setup
+call :dependencymissing ThirdParty\LZ4 "LZ4" && exit /b 0
+
+:: Set up dependencies
+call :visualstudiosetup || exit /b 1
+
+:: Download
+echo Downloading LZ4...
+%powershell% -command "(New-Object Net.WebClient).DownloadFile('https://github.com/lz4/lz4/archive/refs/tags/v%LZ4_VER%.zip', 'temp\lz4.zip')" || call :downloadfailed LZ4 && exit /b 1
+echo Extracting LZ4...
+%powershell% -command "Expand-Archive -Path temp\lz4.zip -DestinationPath temp -Force"
+del temp\lz4.zip /q
+
+:: Build
+echo Building LZ4...
+
+cl /c /O2 /Fotemp\lz4-%LZ4_VER%\lz4.obj /D_MT /D_DLL temp\lz4-%LZ4_VER%\lib\lz4.c || call :buildfailed LZ4 && exit /b 0
+lib /OUT:temp\lz4-%LZ4_VER%\lz4.lib temp\lz4-%LZ4_VER%\lz4.obj || call :buildfailed LZ4 && exit /b 0
+
+:: Copy results
+mkdir ThirdParty\LZ4\Lib
+mkdir ThirdParty\LZ4\Include
+
+robocopy temp\lz4-%LZ4_VER%\lib ThirdParty\LZ4 LICENSE
+robocopy temp\lz4-%LZ4_VER% ThirdParty\LZ4\Lib lz4.lib
+robocopy temp\lz4-%LZ4_VER%\lib ThirdParty\LZ4\Include lz4.h
+
+:: Finish
+echo Cleaning up LZ4 files...
+rmdir temp\lz4-%LZ4_VER% /s /q
+
+echo %COLOR_SUCCESS%LZ4 successfully set up.%COLOR_RESET%
+
+exit /b 0
+
+:zstdsetup
+call :dependencymissing ThirdParty\Zstd "zstd" && exit /b 0
+
+:: Set up dependencies
+call :visualstudiosetup || exit /b 1
+
+:: Download
+echo Downloading zstd...
+%powershell% -command "(New-Object Net.WebClient).DownloadFile('https://github.com/facebook/zstd/archive/refs/tags/v%ZSTD_VER%.zip', 'temp\zstd.zip')" || call :downloadfailed zstd && exit /b 1
+echo Extracting zstd...
+%powershell% -command "Expand-Archive -Path temp\zstd.zip -DestinationPath temp -Force"
+del temp\zstd.zip /q
+
+:: Build
+echo Building zstd...
+
+mkdir temp\zstd-%ZSTD_VER%\build\cmake\build
+cmake temp\zstd-%ZSTD_VER%\build\cmake -Btemp\zstd-%ZSTD_VER%\build\cmake\build -DZSTD_BUILD_SHARED=OFF -DZSTD_BUILD_PROGRAMS=OFF || call :buildfailed zstd && exit /b 1
+
+msbuild temp\zstd-%ZSTD_VER%\build\cmake\build\zstd.sln /target:libzstd_static /p:Configuration="Release" /p:Platform=x64 /p:PlatformToolset=v143 /p:WindowsTargetPlatformVersion=10.0 || call :buildfailed zstd && exit /b 1
+
+:: Copy results
+mkdir ThirdParty\Zstd\Lib
+mkdir ThirdParty\Zstd\Include
+
+robocopy temp\zstd-%ZSTD_VER% ThirdParty\Zstd LICENSE
+robocopy temp\zstd-%ZSTD_VER%\build\cmake\build\lib\Release ThirdParty\Zstd\Lib zstd_static.lib
+robocopy temp\zstd-%ZSTD_VER%\lib ThirdParty\Zstd\Include zstd.h
+
+:: Finish
+echo Cleaning up zstd files...
+rmdir temp\zstd-%ZSTD_VER% /s /q
+
+echo %COLOR_SUCCESS%zstd successfully set up.%COLOR_RESET%
+
+exit /b 0
+
 :pahocppsetup
 call :dependencymissing ThirdParty\PahoCpp "Eclipse Paho" && exit /b 0
 
@@ -491,6 +565,8 @@ call :kvazaarsetup
 call :openhevcsetup
 call :uvgrtpsetup
 call :fpngsetup
+call :lz4setup
+call :zstdsetup
 call :pahocppsetup
 
 if not exist Content (
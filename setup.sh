@@ -8,6 +8,8 @@ YASM_VER="1.3.0"
 UVGRTP_VER="3.1.6"
 OPENHEVC_VER="ffmpeg_update"
 FPNG_VER="1.0.6"
+LZ4_VER="1.10.0"
+ZSTD_VER="1.5.7"
 PAHO_C_VER="1.3.15"
 PAHO_CPP_VER="1.5.3"
 CITHRUS_CONTENT_VER="24_11_2025"
@@ -528,6 +530,88 @@ setup_fpng()
     echo -e "${COLOR_SUCCESS}fpng successfully set up.${COLOR_RESET}"
 }
 
+setup_lz4()
+{
+    if ! dependency_missing ThirdParty/LZ4 LZ4
+    then
+        return 0
+    fi
+
+    # Set up dependencies
+    find_clang || return 1
+
+    # Download
+    echo "Downloading LZ4..."
+    wget -O temp/lz4.zip https://github.com/lz4/lz4/archive/refs/tags/v${LZ4_VER}.zip || { download_failed "LZ4" && return 1; }
+
+    echo "Extracting LZ4..."
+    unzip temp/lz4.zip -d temp
+    rm temp/lz4.zip
+
+    # Build
+    echo "Building LZ4..."
+
+    ${CLANG} -c temp/lz4-${LZ4_VER}/lib/lz4.c -o temp/lz4-${LZ4_VER}/lz4.o -O3 -fPIC || { build_failed "LZ4" && return 1; }
+
+    ar rvs temp/lz4-${LZ4_VER}/liblz4.a temp/lz4-${LZ4_VER}/lz4.o || { build_failed "LZ4" && return 1; }
+
+    # Copy results
+    mkdir -p ThirdParty/LZ4/Lib
+    mkdir -p ThirdParty/LZ4/Include
+
+    cp temp/lz4-${LZ4_VER}/lib/LICENSE ThirdParty/LZ4
+    cp temp/lz4-${LZ4_VER}/lib/lz4.h ThirdParty/LZ4/Include
+    cp temp/lz4-${LZ4_VER}/liblz4.a ThirdParty/LZ4/Lib
+
+    # Finish
+    echo "Cleaning up LZ4 files..."
+    rm -rf temp/lz4-${LZ4_VER}
+
+    echo -e "${COLOR_SUCCESS}LZ4 successfully set up.${COLOR_RESET}"
+}
+
+setup_zstd()
+{
+    if ! dependency_missing ThirdParty/Zstd zstd
+    then
+        return 0
+    fi
+
+    # Set up dependencies
+    find_clang || return 1
+
+    # Download
+    echo "Downloading zstd..."
+    wget -O temp/zstd.tar.gz https://github.com/facebook/zstd/archive/refs/tags/v${ZSTD_VER}.tar.gz || { download_failed "zstd" && return 1; }
+
+    echo "Extracting zstd..."
+    tar -xzvf temp/zstd.tar.gz -C temp
+    rm temp/zstd.tar.gz
+
+    # Build
+    echo "Building zstd..."
+
+    cmake temp/zstd-${ZSTD_VER}/build/cmake -Btemp/zstd-${ZSTD_VER}/Release -DCMAKE_BUILD_TYPE=Release -DZSTD_BUILD_SHARED=OFF -DZSTD_BUILD_PROGRAMS=OFF -DCMAKE_POSITION_INDEPENDENT_CODE=ON "${CMAKE_UE_BUILD_ENV_ARGS[@]}" || { build_failed "zstd" && return 1; }
+
+    cd temp/zstd-${ZSTD_VER}/Release
+    make libzstd_static || { build_failed "zstd" && return 1; }
+    cd ../../..
+
+    # Copy results
+    mkdir -p ThirdParty/Zstd/Lib
+    mkdir -p ThirdParty/Zstd/Include
+
+    cp temp/zstd-${ZSTD_VER}/LICENSE ThirdParty/Zstd
+    cp temp/zstd-${ZSTD_VER}/Release/lib/libzstd.a ThirdParty/Zstd/Lib
+    cp temp/zstd-${ZSTD_VER}/lib/zstd.h ThirdParty/Zstd/Include
+
+    # Finish
+    echo "Cleaning up zstd files..."
+    rm -rf temp/zstd-${ZSTD_VER}
+
+    echo -e "${COLOR_SUCCESS}zstd successfully set up.${COLOR_RESET}"
+}
+
 setup_pahocpp()
 {
     if ! dependency_missing ThirdParty/PahoCpp "Eclipse Paho"
@@ -605,6 +689,8 @@ setup_kvazaar
 setup_openhevc
 setup_uvgrtp
 setup_fpng
+setup_lz4
+setup_zstd
 setup_pahocpp
 
 if [[ ! -d "Content" ]]